@@ -0,0 +1,102 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Compares two equal snapshots of 10M variant<int64_t, uint32_t, E> values,
+// held in a std::vector and in a variant_vector, with operator== on each
+// element and with equal_range_of_variants
+
+#include <boost/variant2/variant.hpp>
+#include <boost/variant2/algorithm.hpp>
+#include <boost/variant2/variant_vector.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace boost::variant2;
+
+enum E { e1, e2, e3 };
+
+using V = variant<std::int64_t, std::uint32_t, E>;
+
+template<class F> void test( char const* name, F f )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    bool r = true;
+
+    for( int i = 0; i < 10; ++i )
+    {
+        r = f() && r;
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::printf( "%s: %lld ms (%d)\n", name, static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), static_cast<int>( r ) );
+}
+
+// a variant operator== through a dispatch, as before
+
+struct eq_dispatch
+{
+    bool operator()( V const& v, V const& w ) const
+    {
+        if( v.index() != w.index() ) return false;
+
+        return visit( [&]( auto const& x ){ return x == get<std::decay_t<decltype(x)>>( w ); }, v );
+    }
+};
+
+template<class It1, class It2, class P> bool equal_loop( It1 first1, It1 last1, It2 first2, P p )
+{
+    for( ; first1 != last1; ++first1, ++first2 )
+    {
+        if( !p( *first1, *first2 ) ) return false;
+    }
+
+    return true;
+}
+
+int main()
+{
+    std::size_t const n = 10 * 1000 * 1000;
+
+    std::vector<V> v1, v2;
+    v1.reserve( n );
+    v2.reserve( n );
+
+    variant_vector<std::int64_t, std::uint32_t, E> w1, w2;
+    w1.reserve( n );
+    w2.reserve( n );
+
+    std::mt19937 rng;
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        unsigned x = rng();
+        V v;
+
+        switch( rng() % 3 )
+        {
+        case 0: v = static_cast<std::int64_t>( x ); break;
+        case 1: v = static_cast<std::uint32_t>( x ); break;
+        case 2: v = static_cast<E>( x % 3 ); break;
+        }
+
+        v1.push_back( v );
+        v2.push_back( v );
+        w1.push_back( v );
+        w2.push_back( v );
+    }
+
+    test( "std::vector, dispatch", [&]{ return equal_loop( v1.begin(), v1.end(), v2.begin(), eq_dispatch() ); } );
+    test( "std::vector, operator==", [&]{ return equal_loop( v1.begin(), v1.end(), v2.begin(), []( V const& v, V const& w ){ return v == w; } ); } );
+    test( "std::vector, equal_range_of_variants", [&]{ return equal_range_of_variants( v1.begin(), v1.end(), v2.begin() ); } );
+    test( "variant_vector, operator== per element", [&]{ return equal_loop( w1.begin(), w1.end(), w2.begin(), []( V const& v, V const& w ){ return v == w; } ); } );
+    test( "variant_vector, equal_range_of_variants", [&]{ return equal_range_of_variants( w1.begin(), w1.end(), w2.begin() ); } );
+}
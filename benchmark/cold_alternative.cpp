@@ -0,0 +1,128 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Visits a stream of messages, almost all of them trades, from many call
+// sites, with the rarely held alternatives marked cold and not
+
+#include <boost/variant2/variant.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace boost::variant2;
+
+struct Trade { unsigned px, qty; };
+
+template<int N> struct Admin { std::string text; };
+template<int N> struct Reject { std::string text; unsigned code; };
+
+namespace boost
+{
+namespace variant2
+{
+
+template<> struct is_cold_alternative<Admin<1>>: std::true_type
+{
+};
+
+template<> struct is_cold_alternative<Reject<1>>: std::true_type
+{
+};
+
+} // namespace variant2
+} // namespace boost
+
+template<int N> using Message = variant<Trade, Admin<N>, Reject<N>>;
+
+// the rare handlers are deliberately large
+
+template<int K> struct handler
+{
+    unsigned operator()( Trade const& m ) const
+    {
+        return m.px * m.qty + K;
+    }
+
+    template<int N> unsigned operator()( Admin<N> const& m ) const
+    {
+        unsigned h = K;
+        for( char ch: m.text ) h = h * 31 + static_cast<unsigned char>( ch );
+        for( char ch: m.text ) h ^= ( h << 5 ) + ( h >> 2 ) + static_cast<unsigned char>( ch );
+        return h;
+    }
+
+    template<int N> unsigned operator()( Reject<N> const& m ) const
+    {
+        unsigned h = m.code + K;
+        for( char ch: m.text ) h = h * 131 + static_cast<unsigned char>( ch );
+        for( char ch: m.text ) h ^= ( h << 7 ) + ( h >> 3 ) + static_cast<unsigned char>( ch );
+        return h;
+    }
+};
+
+template<int N> unsigned route( Message<N> const& m, unsigned k )
+{
+    // many call sites, each with its own inlined visit
+
+    switch( k % 8 )
+    {
+    case 0: return visit( handler<0>(), m );
+    case 1: return visit( handler<1>(), m );
+    case 2: return visit( handler<2>(), m );
+    case 3: return visit( handler<3>(), m );
+    case 4: return visit( handler<4>(), m );
+    case 5: return visit( handler<5>(), m );
+    case 6: return visit( handler<6>(), m );
+    default: return visit( handler<7>(), m );
+    }
+}
+
+template<int N> void test( char const* name, std::size_t n )
+{
+    std::vector<Message<N>> v;
+    v.reserve( n );
+
+    std::mt19937 rng;
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        unsigned x = static_cast<unsigned>( rng() % 1000 );
+
+        switch( rng() % 1000 )
+        {
+        case 0: v.push_back( Admin<N>{ "admin message" } ); break;
+        case 1: v.push_back( Reject<N>{ "reject message", x } ); break;
+        default: v.push_back( Trade{ x, x + 1 } ); break;
+        }
+    }
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    unsigned s = 0;
+
+    for( int k = 0; k < 20; ++k )
+    {
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            s += route<N>( v[ i ], static_cast<unsigned>( i ) );
+        }
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::printf( "%s: %lld ms (%u)\n", name, static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), s );
+}
+
+int main()
+{
+    std::size_t const n = 4 * 1024 * 1024;
+
+    test<0>( "not cold", n );
+    test<1>( "cold", n );
+}
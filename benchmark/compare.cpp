@@ -0,0 +1,63 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Sorts 10M random variant<int, double, std::string> values with operator<,
+// with compare_less and, under C++20, with operator<=>
+
+#include <boost/variant2/variant.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace boost::variant2;
+
+using V = variant<int, double, std::string>;
+
+template<class Cmp> void test( char const* name, std::vector<V> v, Cmp cmp )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::sort( v.begin(), v.end(), cmp );
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::printf( "%s: %lld ms (%d)\n", name, static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), static_cast<int>( std::is_sorted( v.begin(), v.end() ) ) );
+}
+
+int main()
+{
+    std::size_t const n = 10 * 1000 * 1000;
+
+    std::vector<V> v;
+    v.reserve( n );
+
+    std::mt19937 rng;
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        unsigned x = rng();
+
+        switch( rng() % 3 )
+        {
+        case 0: v.push_back( static_cast<int>( x % 1000000 ) ); break;
+        case 1: v.push_back( x * 0.5 ); break;
+        case 2: v.push_back( "key" + std::to_string( x % 1000000 ) ); break;
+        }
+    }
+
+    test( "operator<", v, []( V const& a, V const& b ){ return a < b; } );
+    test( "compare_less", v, compare_less() );
+
+#if defined( BOOST_VARIANT2_HAS_THREE_WAY_COMPARISON )
+
+    test( "operator<=>", v, []( V const& a, V const& b ){ return ( a <=> b ) < 0; } );
+
+#endif
+}
@@ -0,0 +1,108 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Visits arrays of variants with 3, 16 and 64 alternatives under each
+// dispatch policy, with the held index uniformly distributed, skewed
+// towards the first alternative, and constant
+
+#include <boost/variant2/variant.hpp>
+#include <boost/mp11.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace boost::variant2;
+using namespace boost::mp11;
+
+template<class I> struct Z
+{
+    unsigned v;
+};
+
+template<std::size_t N> using V = mp_rename<mp_transform<Z, mp_iota_c<N>>, variant>;
+
+struct F
+{
+    template<class I> unsigned operator()( Z<I> const& z ) const
+    {
+        return z.v * static_cast<unsigned>( I::value + 1 );
+    }
+};
+
+enum distribution { uniform, skewed, constant };
+
+template<std::size_t N> std::vector<V<N>> make( distribution d, std::size_t n )
+{
+    std::vector<V<N>> v;
+    v.reserve( n );
+
+    std::mt19937 rng;
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        std::size_t k = 0;
+
+        switch( d )
+        {
+        case uniform: k = rng() % N; break;
+        case skewed: k = rng() % 8 == 0? rng() % N: 0; break;
+        case constant: k = N / 2; break;
+        }
+
+        v.push_back( mp_with_index<N>( k, [&]( auto I ){ return V<N>( in_place_index<I>, Z<decltype(I)>{ static_cast<unsigned>( i ) } ); } ) );
+    }
+
+    return v;
+}
+
+template<class D, std::size_t N> void test( char const* name, std::vector<V<N>> const& v )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    unsigned s = 0;
+
+    for( int k = 0; k < 10; ++k )
+    {
+        for( auto const& x: v )
+        {
+            s += visit<D>( F(), x );
+        }
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::printf( "    %-14s %5lld ms (%u)\n", name, static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), s );
+}
+
+template<std::size_t N> void test( distribution d, char const* name, std::size_t n )
+{
+    std::printf( "%zu alternatives, %s index:\n", N, name );
+
+    auto v = make<N>( d, n );
+
+    test<dispatch::dense_switch, N>( "dense_switch", v );
+    test<dispatch::jump_table, N>( "jump_table", v );
+    test<dispatch::binary_search, N>( "binary_search", v );
+    test<dispatch::if_chain, N>( "if_chain", v );
+}
+
+template<std::size_t N> void test( std::size_t n )
+{
+    test<N>( uniform, "uniform", n );
+    test<N>( skewed, "skewed", n );
+    test<N>( constant, "constant", n );
+}
+
+int main()
+{
+    std::size_t const n = 4 * 1024 * 1024;
+
+    test<3>( n );
+    test<16>( n );
+    test<64>( n );
+}
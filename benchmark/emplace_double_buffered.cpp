@@ -0,0 +1,188 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Assigns ints, doubles and strings to random elements of 4, 16 and 64 MB
+// arrays of
+// double buffered variant<int, double, std::string, X> values, where X has
+// 120 bytes and can't be moved without throwing, and reports the time and,
+// on Linux, the cache misses counted by perf_event_open
+
+#include <boost/variant2/variant.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+# include <linux/perf_event.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+using namespace boost::variant2;
+
+// can't be moved without throwing, so the variant is double buffered
+struct X
+{
+    char data[ 120 ];
+
+    X() {}
+    X( X const& r ) { std::memcpy( data, r.data, sizeof( data ) ); }
+    X& operator=( X const& r ) { std::memcpy( data, r.data, sizeof( data ) ); return *this; }
+};
+
+using V = variant<int, double, std::string, X>;
+
+class cache_misses
+{
+private:
+
+    int fd_ = -1;
+
+public:
+
+    cache_misses()
+    {
+#if defined(__linux__)
+
+        perf_event_attr attr;
+        std::memset( &attr, 0, sizeof( attr ) );
+
+        attr.size = sizeof( attr );
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        fd_ = static_cast<int>( syscall( __NR_perf_event_open, &attr, 0, -1, -1, 0 ) );
+
+#endif
+    }
+
+    ~cache_misses()
+    {
+#if defined(__linux__)
+
+        if( fd_ >= 0 ) close( fd_ );
+
+#endif
+    }
+
+    cache_misses( cache_misses const& ) = delete;
+    cache_misses& operator=( cache_misses const& ) = delete;
+
+    void start()
+    {
+#if defined(__linux__)
+
+        if( fd_ >= 0 )
+        {
+            ioctl( fd_, PERF_EVENT_IOC_RESET, 0 );
+            ioctl( fd_, PERF_EVENT_IOC_ENABLE, 0 );
+        }
+
+#endif
+    }
+
+    // returns -1 when the counter isn't available
+
+    long long stop()
+    {
+        long long r = -1;
+
+#if defined(__linux__)
+
+        if( fd_ >= 0 )
+        {
+            ioctl( fd_, PERF_EVENT_IOC_DISABLE, 0 );
+
+            if( read( fd_, &r, sizeof( r ) ) != sizeof( r ) ) r = -1;
+        }
+
+#endif
+
+        return r;
+    }
+};
+
+template<class F> void test( char const* name, std::vector<V>& v, std::vector<std::uint32_t> const& ix, F f )
+{
+    cache_misses cm;
+
+    auto t1 = std::chrono::steady_clock::now();
+    cm.start();
+
+    for( std::size_t i = 0; i < ix.size(); ++i )
+    {
+        f( v[ ix[ i ] ], i );
+    }
+
+    long long m = cm.stop();
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::size_t s = 0;
+
+    for( auto const& x: v )
+    {
+        s += x.index();
+    }
+
+    std::printf( "%s: %lld ms, %lld cache misses (s=%zu)\n", name, static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), m, s );
+}
+
+static void test( std::size_t size )
+{
+    std::size_t const n = size / sizeof( V );
+    std::size_t const k = 20 * 1000 * 1000;
+
+    std::printf( "%zu MB:\n", size / 1024 / 1024 );
+
+    std::vector<V> v( n );
+
+    std::vector<std::uint32_t> ix( k );
+
+    std::mt19937 rng;
+
+    for( auto& x: ix )
+    {
+        x = static_cast<std::uint32_t>( rng() % n );
+    }
+
+    std::string const str( "abc" );
+
+    test( "  int", v, ix, []( V& x, std::size_t i ){
+
+        x = static_cast<int>( i );
+
+    });
+
+    test( "  int and double", v, ix, []( V& x, std::size_t i ){
+
+        if( i & 1 ) x = static_cast<double>( i ); else x = static_cast<int>( i );
+
+    });
+
+    test( "  int and short string", v, ix, [&]( V& x, std::size_t i ){
+
+        if( i & 1 ) x = str; else x = static_cast<int>( i );
+
+    });
+}
+
+int main()
+{
+    std::printf( "sizeof(V): %zu\n", sizeof( V ) );
+
+    test( 4 * 1024 * 1024 );
+    test( 16 * 1024 * 1024 );
+    test( 64 * 1024 * 1024 );
+}
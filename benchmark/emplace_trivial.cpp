@@ -0,0 +1,64 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Stores small alternatives into a vector of trivially copyable variants
+// with a large alternative, through emplace (which writes only the new
+// alternative) and through assignment of a whole variant
+
+#include <boost/variant2/variant.hpp>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace boost::variant2;
+
+using V = variant<char, int, std::array<char, 60>>;
+
+template<class F> void test( char const* name, std::vector<V>& v, int k, F f )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    for( int j = 0; j < k; ++j )
+    {
+        for( std::size_t i = 0; i < v.size(); ++i )
+        {
+            f( v[ i ], static_cast<int>( i + j ) );
+        }
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    long long s = 0;
+
+    for( auto const& x: v )
+    {
+        s += x.index() == 0? get<0>( x ): get<1>( x );
+    }
+
+    std::printf( "%s: %lld ms (s=%lld)\n", name, static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), s );
+}
+
+int main()
+{
+    std::size_t const n = 64 * 1024;
+    int const k = 2000;
+
+    std::vector<V> v( n );
+
+    test( "emplace", v, k, []( V& x, int i ){
+
+        if( i & 1 ) x.emplace<0>( static_cast<char>( i ) ); else x.emplace<1>( i );
+
+    });
+
+    test( "assign whole variant", v, k, []( V& x, int i ){
+
+        if( i & 1 ) x = V( in_place_index<0>, static_cast<char>( i ) ); else x = V( in_place_index<1>, i );
+
+    });
+}
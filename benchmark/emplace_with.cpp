@@ -0,0 +1,69 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Stores 4 KB buffers returned by a function into a variant, with
+// emplace<T>( make() ), which moves the returned buffer, and with
+// emplace_with<T>( make ), which constructs it in place since C++17
+
+#include <boost/variant2/variant.hpp>
+#include <array>
+#include <chrono>
+#include <cstdio>
+
+using namespace boost::variant2;
+
+struct Buffer
+{
+    std::array<char, 4096> data;
+
+    explicit Buffer( int x ) noexcept
+    {
+        data.fill( static_cast<char>( x ) );
+    }
+};
+
+BOOST_NOINLINE Buffer make( int x )
+{
+    return Buffer( x );
+}
+
+using V = variant<int, Buffer>;
+
+template<class F> void test( char const* name, F f )
+{
+    int const k = 1000000;
+
+    V v( 0 );
+    int s = 0;
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    for( int i = 0; i < k; ++i )
+    {
+        s += f( v, i );
+        v.emplace<0>( i );
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::printf( "%s: %lld ms (%d)\n", name, static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), s );
+}
+
+int main()
+{
+    test( "emplace<T>( make() )", []( V& v, int i ){
+
+        return v.emplace<Buffer>( make( i ) ).data[ i % 4096 ];
+
+    });
+
+    test( "emplace_with<T>( make )", []( V& v, int i ){
+
+        return v.emplace_with<Buffer>( [&]{ return make( i ); } ).data[ i % 4096 ];
+
+    });
+}
@@ -0,0 +1,112 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Inserts and looks up variant<int, std::string> keys in std::unordered_map,
+// against int keys, and hashes arrays of variant<int, unsigned, long> with
+// hash_range, against combining std::hash in a loop
+
+#include <boost/variant2/variant.hpp>
+#include <boost/variant2/algorithm.hpp>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace boost::variant2;
+
+template<class F> void test( char const* name, F f )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::size_t s = 0;
+
+    for( int k = 0; k < 10; ++k )
+    {
+        s += f();
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::printf( "%s: %lld ms (%zu)\n", name, static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), s );
+}
+
+template<class K> std::size_t map_test( std::vector<K> const& keys )
+{
+    std::unordered_map<K, int> m;
+
+    for( auto const& k: keys ) ++m[ k ];
+
+    std::size_t s = 0;
+
+    for( auto const& k: keys ) s += m.find( k )->second;
+
+    return s;
+}
+
+int main()
+{
+    std::size_t const n = 1024 * 1024;
+
+    std::mt19937 rng;
+
+    {
+        using V = variant<int, std::string>;
+
+        std::vector<int> v;
+        std::vector<V> w;
+
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            int x = static_cast<int>( rng() % ( n / 2 ) );
+
+            v.push_back( x );
+
+            if( x % 8 == 0 ) w.push_back( std::to_string( x ) ); else w.push_back( x );
+        }
+
+        test( "std::unordered_map<int>", [&]{ return map_test( v ); } );
+        test( "std::unordered_map<variant<int, std::string>>", [&]{ return map_test( w ); } );
+    }
+
+    using V = variant<int, unsigned, long>;
+
+    for( unsigned d: { 16, 3 } )
+    {
+        std::vector<V> v;
+
+        for( std::size_t i = 0; i < 16 * n; ++i )
+        {
+            int x = static_cast<int>( rng() );
+
+            switch( rng() % d )
+            {
+            case 0: v.push_back( static_cast<unsigned>( x ) ); break;
+            case 1: v.push_back( static_cast<long>( x ) ); break;
+            default: v.push_back( x ); break;
+            }
+        }
+
+        std::printf( d == 3? "uniform over 3 alternatives:\n": "mostly int:\n" );
+
+        test( "    std::hash in a loop", [&]{
+
+            std::size_t h = 0;
+            for( auto const& x: v ) h = h * 31 + std::hash<V>()( x );
+            return h;
+
+        });
+
+        test( "    hash_range", [&]{
+
+            return hash_range( v.begin(), v.end() );
+
+        });
+    }
+}
@@ -0,0 +1,86 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Assigns alternately to the elements of a vector of variants with a
+// throwing move alternative, double buffered and with heap backup
+
+#include <boost/variant2/variant.hpp>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace boost::variant2;
+
+template<int N> struct X
+{
+    int v;
+
+    X( int v ): v( v ) {}
+    X( X const& r ): v( r.v ) {}
+    X( X&& r ): v( r.v ) {}
+    X& operator=( X const& ) = default;
+};
+
+using V1 = variant<std::string, X<1>>;
+using V2 = variant<std::string, X<2>>;
+
+namespace boost
+{
+namespace variant2
+{
+
+template<> struct use_heap_backup<V2>: std::true_type
+{
+};
+
+} // namespace variant2
+} // namespace boost
+
+template<class V> void test( char const* name, std::size_t n, int k )
+{
+    using U = variant_alternative_t<1, V>;
+
+    std::vector<V> v( n );
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    for( int j = 0; j < k; ++j )
+    {
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            if( ( i + j ) % 2 == 0 )
+            {
+                v[ i ].template emplace<U>( static_cast<int>( i ) );
+            }
+            else
+            {
+                v[ i ].template emplace<0>( "short" );
+            }
+        }
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::size_t s = 0;
+
+    for( auto const& x: v )
+    {
+        s += x.index();
+    }
+
+    std::printf( "%s (%zu bytes): %lld ms (s=%zu)\n", name, sizeof( V ), static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), s );
+}
+
+int main()
+{
+    std::size_t const n = 1024 * 1024;
+    int const k = 20;
+
+    test<V1>( "double buffered", n, k );
+    test<V2>( "heap backup", n, k );
+}
@@ -0,0 +1,90 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Double dispatch over pairs of random shapes; build with
+// BOOST_VARIANT2_MAX_FLAT_VISIT=0 for nested dispatch
+
+#include <boost/variant2/variant.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace boost::variant2;
+
+struct Circle { float r; };
+struct Box { float w, h; };
+struct Segment { float l; };
+struct Point {};
+
+using Shape = variant<Circle, Box, Segment, Point>;
+
+static float extent( Circle const& c ) { return c.r; }
+static float extent( Box const& b ) { return b.w + b.h; }
+static float extent( Segment const& s ) { return s.l; }
+static float extent( Point const& ) { return 0; }
+
+struct collide
+{
+    template<class A, class B> float operator()( A const& a, B const& b ) const
+    {
+        return extent( a ) - extent( b );
+    }
+
+    float operator()( Point const&, Point const& ) const
+    {
+        return 0;
+    }
+};
+
+static std::vector<Shape> make( std::size_t n, std::mt19937& rng )
+{
+    std::vector<Shape> v;
+    v.reserve( n );
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        float x = static_cast<float>( rng() % 100 );
+
+        switch( rng() % 4 )
+        {
+        case 0: v.push_back( Circle{ x } ); break;
+        case 1: v.push_back( Box{ x, x } ); break;
+        case 2: v.push_back( Segment{ x } ); break;
+        case 3: v.push_back( Point{} ); break;
+        }
+    }
+
+    return v;
+}
+
+int main()
+{
+    std::size_t const n = 1024 * 1024;
+
+    std::mt19937 rng;
+
+    std::vector<Shape> v = make( n, rng );
+    std::vector<Shape> w = make( n, rng );
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    int s = 0;
+
+    for( int k = 0; k < 20; ++k )
+    {
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            s += visit( collide(), v[ i ], w[ i ] ) < 0;
+        }
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::printf( "%s dispatch: %lld ms (%d)\n", BOOST_VARIANT2_MAX_FLAT_VISIT >= 16? "flat": "nested",
+        static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), s );
+}
@@ -0,0 +1,79 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Sums a vector of interpreter-style values, stored as variant and as
+// nan_variant, through visit
+
+#include <boost/variant2/nan_variant.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace boost::variant2;
+
+struct Object
+{
+    double v;
+};
+
+struct F
+{
+    double operator()( double x ) const { return x; }
+    double operator()( std::int32_t x ) const { return x; }
+    double operator()( bool x ) const { return x; }
+    double operator()( monostate ) const { return 0; }
+    double operator()( Object* p ) const { return p->v; }
+};
+
+template<class V> void test( char const* name, std::size_t n, int k )
+{
+    static Object obj{ 0.5 };
+
+    std::vector<V> v;
+    v.reserve( n );
+
+    std::mt19937 rng;
+    std::uniform_int_distribution<int> dist( 0, 99 );
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        int r = dist( rng );
+
+        if( r < 60 ) v.push_back( V( r * 0.25 ) );
+        else if( r < 90 ) v.push_back( V( static_cast<std::int32_t>( r ) ) );
+        else if( r < 95 ) v.push_back( V( r % 2 == 0 ) );
+        else if( r < 98 ) v.push_back( V( monostate() ) );
+        else v.push_back( V( &obj ) );
+    }
+
+    auto t1 = std::chrono::steady_clock::now();
+
+    double s = 0;
+
+    for( int j = 0; j < k; ++j )
+    {
+        for( auto const& x: v )
+        {
+            s += visit( F(), x ) * 1.0001 + 0.5;
+        }
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::printf( "%s (%zu bytes): %lld ms (s=%g)\n", name, sizeof( V ), static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), s );
+}
+
+int main()
+{
+    std::size_t const n = 16 * 1024 * 1024;
+    int const k = 10;
+
+    test< variant<double, std::int32_t, bool, monostate, Object*> >( "variant", n, k );
+    test< nan_variant<double, std::int32_t, bool, monostate, Object*> >( "nan_variant", n, k );
+}
@@ -0,0 +1,123 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Compares std::vector<variant<SmallEvent, HugeSnapshot>> with
+// packed_variant_buffer<SmallEvent, HugeSnapshot>, mostly holding small
+// events: memory, appending, and visiting every element
+
+#include <boost/variant2/packed_variant_buffer.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace boost::variant2;
+
+struct SmallEvent
+{
+    int id;
+    float value;
+};
+
+struct HugeSnapshot
+{
+    int id;
+    float values[ 255 ];
+};
+
+using V = variant<SmallEvent, HugeSnapshot>;
+using PB = packed_variant_buffer<SmallEvent, HugeSnapshot>;
+
+struct value
+{
+    double operator()( SmallEvent const& e ) const { return e.value; }
+    double operator()( HugeSnapshot const& s ) const { return s.values[ 0 ]; }
+};
+
+template<class F> void test( char const* name, F f )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    double s = 0;
+
+    for( int k = 0; k < 20; ++k )
+    {
+        s += f();
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::printf( "%s: %lld ms (%.0f)\n", name, static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), s );
+}
+
+int main()
+{
+    std::size_t const n = 1024 * 1024;
+
+    std::vector<bool> huge( n );
+
+    {
+        std::mt19937 rng;
+
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            huge[ i ] = rng() % 100 == 0;
+        }
+    }
+
+    std::vector<V> v;
+    PB w;
+
+    test( "std::vector<variant>, append", [&]{
+
+        v.clear();
+
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            int x = static_cast<int>( i );
+
+            if( huge[ i ] ) v.push_back( HugeSnapshot{ x, { 1.0f } } ); else v.push_back( SmallEvent{ x, 0.5f } );
+        }
+
+        return static_cast<double>( v.size() );
+
+    });
+
+    test( "packed_variant_buffer, append", [&]{
+
+        w.clear();
+
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            int x = static_cast<int>( i );
+
+            if( huge[ i ] ) w.push_back( HugeSnapshot{ x, { 1.0f } } ); else w.push_back( SmallEvent{ x, 0.5f } );
+        }
+
+        return static_cast<double>( w.size() );
+
+    });
+
+    std::printf( "std::vector<variant>: %zu MB\n", v.size() * sizeof( V ) >> 20 );
+    std::printf( "packed_variant_buffer: %zu MB\n", w.size_bytes() >> 20 );
+
+    test( "std::vector<variant>, visit", [&]{
+
+        double s = 0;
+        for( auto const& x: v ) s += visit( value(), x );
+        return s;
+
+    });
+
+    test( "packed_variant_buffer, visit", [&]{
+
+        double s = 0;
+        for( auto x: w ) s += visit( value(), x );
+        return s;
+
+    });
+}
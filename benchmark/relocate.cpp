@@ -0,0 +1,151 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Grows and sorts large arrays of variants whose alternatives are, and
+// are not, declared trivially relocatable
+
+#include <boost/variant2/variant.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace boost::variant2;
+
+// std::vector doesn't point into itself on any of the major implementations
+
+template<int N> struct Vec
+{
+    std::vector<int> v;
+};
+
+namespace boost
+{
+namespace variant2
+{
+
+template<> struct is_trivially_relocatable<Vec<1>>: std::true_type
+{
+};
+
+} // namespace variant2
+} // namespace boost
+
+using V1 = variant<Vec<1>, int>;
+using V2 = variant<Vec<2>, int>;
+
+static int key( Vec<1> const& x ) { return x.v.front(); }
+static int key( Vec<2> const& x ) { return x.v.front(); }
+static int key( int x ) { return x; }
+
+// a minimal growable array that relocates its elements when it grows
+
+template<class T> class buffer
+{
+private:
+
+    T* p_ = 0;
+    std::size_t n_ = 0;
+    std::size_t c_ = 0;
+
+public:
+
+    buffer() = default;
+    buffer( buffer const& ) = delete;
+    buffer& operator=( buffer const& ) = delete;
+
+    ~buffer()
+    {
+        for( std::size_t i = 0; i < n_; ++i ) p_[ i ].~T();
+        std::allocator<T>().deallocate( p_, c_ );
+    }
+
+    template<class A> void push_back( A&& a )
+    {
+        if( n_ == c_ )
+        {
+            std::size_t c = c_? 2 * c_: 16;
+            T* p = std::allocator<T>().allocate( c );
+
+            uninitialized_relocate( p_, p_ + n_, p );
+            std::allocator<T>().deallocate( p_, c_ );
+
+            p_ = p;
+            c_ = c;
+        }
+
+        ::new( static_cast<void*>( p_ + n_ ) ) T( std::forward<A>(a) );
+        ++n_;
+    }
+
+    T* begin() { return p_; }
+    T* end() { return p_ + n_; }
+};
+
+template<class C, class V> void fill( C& c, std::size_t n )
+{
+    using W = variant_alternative_t<0, V>;
+
+    std::mt19937 rng;
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        int r = static_cast<int>( rng() % 1000000 );
+
+        if( r % 2 ) c.push_back( V( r ) ); else c.push_back( V( W{ std::vector<int>( 1, r ) } ) );
+    }
+}
+
+template<class V> void test( char const* name, std::size_t n )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    {
+        std::vector<V> v;
+        fill<std::vector<V>, V>( v, n );
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    {
+        buffer<V> v;
+        fill<buffer<V>, V>( v, n );
+    }
+
+    auto t3 = std::chrono::steady_clock::now();
+
+    std::vector<V> v;
+    fill<std::vector<V>, V>( v, n );
+
+    auto t4 = std::chrono::steady_clock::now();
+
+    std::sort( v.begin(), v.end(), []( V const& a, V const& b ){
+
+        return visit( []( auto const& x ){ return key( x ); }, a ) < visit( []( auto const& x ){ return key( x ); }, b );
+
+    });
+
+    auto t5 = std::chrono::steady_clock::now();
+
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+
+    std::printf( "%s: std::vector growth %lld ms, relocating growth %lld ms, sort %lld ms\n", name,
+        static_cast<long long>( duration_cast<milliseconds>( t2 - t1 ).count() ),
+        static_cast<long long>( duration_cast<milliseconds>( t3 - t2 ).count() ),
+        static_cast<long long>( duration_cast<milliseconds>( t5 - t4 ).count() ) );
+}
+
+int main()
+{
+    std::size_t const n = 4 * 1024 * 1024;
+
+    test<V1>( "trivially relocatable", n );
+    test<V2>( "not trivially relocatable", n );
+}
@@ -0,0 +1,123 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Counts, finds and selects the elements holding an alternative, with
+// std::count_if over std::vector<variant>, count_alternative over
+// std::vector<variant>, and count_alternative over the index array of
+// variant_vector; build with BOOST_VARIANT2_NO_AVX2 or
+// BOOST_VARIANT2_NO_SIMD for the SSE2 and scalar kernels
+
+#include <boost/variant2/variant_vector.hpp>
+#include <boost/variant2/algorithm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace boost::variant2;
+
+using V = variant<int, float, double>;
+using VV = variant_vector<int, float, double>;
+
+template<class F> void test( char const* name, F f )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::size_t s = 0;
+
+    for( int k = 0; k < 50; ++k )
+    {
+        s += f();
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::printf( "%s: %lld ms (%zu)\n", name, static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), s );
+}
+
+int main()
+{
+    std::size_t const n = 4 * 1024 * 1024;
+
+    std::vector<V> v;
+    VV w;
+
+    v.reserve( n );
+    w.reserve( n );
+
+    std::mt19937 rng;
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        switch( rng() % 3 )
+        {
+        case 0: v.push_back( 1 ); w.push_back( 1 ); break;
+        case 1: v.push_back( 1.0f ); w.push_back( 1.0f ); break;
+        case 2: v.push_back( 1.0 ); w.push_back( 1.0 ); break;
+        }
+    }
+
+    // a single double at the end, for find
+
+    std::vector<V> v2( n, V( 1 ) );
+    VV w2;
+
+    for( std::size_t i = 0; i < n - 1; ++i ) w2.push_back( 1 );
+
+    v2.back() = 1.0;
+    w2.push_back( 1.0 );
+
+    test( "std::count_if, std::vector<variant>", [&]{
+
+        return static_cast<std::size_t>( std::count_if( v.begin(), v.end(), []( V const& x ){ return holds_alternative<float>( x ); } ) );
+
+    });
+
+    test( "count_alternative, std::vector<variant>", [&]{
+
+        return count_alternative<float>( v.begin(), v.end() );
+
+    });
+
+    test( "count_alternative, variant_vector", [&]{
+
+        return count_alternative<float>( w.begin(), w.end() );
+
+    });
+
+    test( "std::find_if, std::vector<variant>", [&]{
+
+        return static_cast<std::size_t>( std::find_if( v2.begin(), v2.end(), []( V const& x ){ return holds_alternative<double>( x ); } ) - v2.begin() );
+
+    });
+
+    test( "find_alternative, variant_vector", [&]{
+
+        return static_cast<std::size_t>( find_alternative<double>( w2.begin(), w2.end() ) - w2.begin() );
+
+    });
+
+    std::vector<std::size_t> sel;
+    sel.reserve( n );
+
+    test( "select_alternative, std::vector<variant>", [&]{
+
+        sel.clear();
+        select_alternative<float>( v.begin(), v.end(), std::back_inserter( sel ) );
+        return sel.size();
+
+    });
+
+    test( "select_alternative, variant_vector", [&]{
+
+        sel.clear();
+        select_alternative<float>( w.begin(), w.end(), std::back_inserter( sel ) );
+        return sel.size();
+
+    });
+}
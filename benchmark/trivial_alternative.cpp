@@ -0,0 +1,107 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Copies, moves and destroys 16K variant<int, double, std::string> values,
+// with 100%, 95% and 50% of them holding an int and the rest a double or
+// a string, in random order
+
+#include <boost/variant2/variant.hpp>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace boost::variant2;
+
+using V = variant<int, double, std::string>;
+
+using clock_type = std::chrono::steady_clock;
+
+static long long ms( clock_type::duration d )
+{
+    return static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( d ).count() );
+}
+
+static void test( int percent )
+{
+    std::size_t const n = 16 * 1024;
+    int const k = 2000;
+
+    std::vector<V> v;
+    v.reserve( n );
+
+    std::mt19937 rng;
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        unsigned x = rng();
+
+        if( static_cast<int>( x % 100 ) < percent )
+        {
+            v.push_back( static_cast<int>( x ) );
+        }
+        else if( x & 1 )
+        {
+            v.push_back( x * 0.5 );
+        }
+        else
+        {
+            v.push_back( std::string( "str" ) );
+        }
+    }
+
+    std::unique_ptr<V, void(*)( V* )> p( static_cast<V*>( ::operator new( n * sizeof( V ) ) ), []( V* q ){ ::operator delete( q ); } );
+    std::unique_ptr<V, void(*)( V* )> q( static_cast<V*>( ::operator new( n * sizeof( V ) ) ), []( V* q ){ ::operator delete( q ); } );
+
+    clock_type::duration tc{}, tm{}, td{};
+    std::size_t s = 0;
+
+    for( int j = 0; j < k; ++j )
+    {
+        auto t1 = clock_type::now();
+
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            ::new( p.get() + i ) V( v[ i ] );
+        }
+
+        auto t2 = clock_type::now();
+
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            ::new( q.get() + i ) V( std::move( p.get()[ i ] ) );
+        }
+
+        auto t3 = clock_type::now();
+
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            s += p.get()[ i ].index() + q.get()[ i ].index();
+
+            p.get()[ i ].~V();
+            q.get()[ i ].~V();
+        }
+
+        auto t4 = clock_type::now();
+
+        tc += t2 - t1;
+        tm += t3 - t2;
+        td += t4 - t3;
+    }
+
+    std::printf( "%3d%% int: copy %lld ms, move %lld ms, destroy %lld ms (s=%zu)\n", percent, ms( tc ), ms( tm ), ms( td ), s );
+}
+
+int main()
+{
+    test( 100 );
+    test( 95 );
+    test( 50 );
+}
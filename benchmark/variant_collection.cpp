@@ -0,0 +1,92 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Updates a mix of random entities, held in std::vector<variant> and
+// visited one at a time, or in variant_collection and updated a segment
+// at a time
+
+#include <boost/variant2/variant_collection.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace boost::variant2;
+
+struct Particle { float x, v; };
+struct Body { float x, v, m; };
+struct Wall { float x; };
+struct Spring { float x, k; };
+
+using V = variant<Particle, Body, Wall, Spring>;
+using VC = variant_collection<Particle, Body, Wall, Spring>;
+
+struct update
+{
+    void operator()( Particle& p ) const { p.x += p.v; }
+    void operator()( Body& b ) const { b.x += b.v / b.m; }
+    void operator()( Wall& ) const {}
+    void operator()( Spring& s ) const { s.x -= s.k * s.x; }
+};
+
+template<class F> void test( char const* name, F f )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    for( int k = 0; k < 20; ++k )
+    {
+        f();
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::printf( "%s: %lld ms\n", name, static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ) );
+}
+
+int main()
+{
+    std::size_t const n = 4 * 1024 * 1024;
+
+    std::vector<V> v;
+    VC w;
+
+    v.reserve( n );
+
+    std::mt19937 rng;
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        float x = static_cast<float>( rng() % 100 );
+
+        switch( rng() % 4 )
+        {
+        case 0: v.push_back( Particle{ x, 1 } ); w.insert( Particle{ x, 1 } ); break;
+        case 1: v.push_back( Body{ x, 1, 2 } ); w.insert( Body{ x, 1, 2 } ); break;
+        case 2: v.push_back( Wall{ x } ); w.insert( Wall{ x } ); break;
+        case 3: v.push_back( Spring{ x, 0.5f } ); w.insert( Spring{ x, 0.5f } ); break;
+        }
+    }
+
+    test( "std::vector<variant>, visit", [&]{
+
+        for( auto& x: v ) visit( update(), x );
+
+    });
+
+    test( "variant_collection, for_each", [&]{
+
+        w.for_each( update() );
+
+    });
+
+    float s1 = 0, s2 = 0;
+
+    for( auto const& x: v ) s1 += visit( []( auto const& y ){ return y.x; }, x );
+    w.for_each( [&]( auto const& y ){ s2 += y.x; } );
+
+    std::printf( "%.0f %.0f\n", s1, s2 );
+}
@@ -0,0 +1,110 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Compares std::vector<variant<int, double, Big>> with variant_vector<int,
+// double, Big>, mostly holding ints: memory, visiting every element, and
+// summing the ints
+
+#include <boost/variant2/variant_vector.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace boost::variant2;
+
+struct Big
+{
+    int v;
+    int data[ 31 ];
+};
+
+using V = variant<int, double, Big>;
+using VV = variant_vector<int, double, Big>;
+
+struct value
+{
+    double operator()( int x ) const { return x; }
+    double operator()( double x ) const { return x; }
+    double operator()( Big const& b ) const { return b.v; }
+};
+
+template<class F> void test( char const* name, F f )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    double s = 0;
+
+    for( int k = 0; k < 20; ++k )
+    {
+        s += f();
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::printf( "%s: %lld ms (%.0f)\n", name, static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), s );
+}
+
+int main()
+{
+    std::size_t const n = 4 * 1024 * 1024;
+
+    std::vector<V> v;
+    VV w;
+
+    v.reserve( n );
+    w.reserve( n );
+
+    std::mt19937 rng;
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        int x = static_cast<int>( rng() % 1000 );
+
+        switch( rng() % 100 )
+        {
+        case 0: v.push_back( Big{ x, {} } ); w.push_back( Big{ x, {} } ); break;
+        case 1: case 2: case 3: case 4: v.push_back( x * 0.5 ); w.push_back( x * 0.5 ); break;
+        default: v.push_back( x ); w.push_back( x ); break;
+        }
+    }
+
+    std::printf( "std::vector<variant>: %zu MB\n", v.size() * sizeof( V ) >> 20 );
+    std::printf( "variant_vector: %zu MB\n", ( w.size() * ( 1 + sizeof( std::size_t ) ) + w.alternative<0>().size() * sizeof( int ) + w.alternative<1>().size() * sizeof( double ) + w.alternative<2>().size() * sizeof( Big ) ) >> 20 );
+
+    test( "std::vector<variant>, visit", [&]{
+
+        double s = 0;
+        for( auto const& x: v ) s += visit( value(), x );
+        return s;
+
+    });
+
+    test( "variant_vector, visit", [&]{
+
+        double s = 0;
+        for( auto x: w ) s += visit( value(), x );
+        return s;
+
+    });
+
+    test( "std::vector<variant>, ints", [&]{
+
+        double s = 0;
+        for( auto const& x: v ) if( auto p = get_if<int>( &x ) ) s += *p;
+        return s;
+
+    });
+
+    test( "variant_vector, ints", [&]{
+
+        double s = 0;
+        for( int x: w.alternative<0>() ) s += x;
+        return s;
+
+    });
+}
@@ -0,0 +1,122 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Sums a vector of variants with visit in a loop, visit_each and
+// visit_each_ordered, for index sequences of decreasing entropy
+
+#include <boost/variant2/algorithm.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace boost::variant2;
+
+struct A { float x; };
+struct B { float x, y; };
+struct C { int n; };
+struct D { double d; };
+
+using V = variant<A, B, C, D>;
+
+struct sum
+{
+    double s = 0;
+
+    void operator()( A const& a ) { s += a.x; }
+    void operator()( B const& b ) { s += b.x * b.y; }
+    void operator()( C const& c ) { s += c.n; }
+    void operator()( D const& d ) { s -= d.d; }
+};
+
+enum distribution { uniform, skewed, runs, constant };
+
+static std::vector<V> make( distribution d, std::size_t n )
+{
+    std::vector<V> v;
+    v.reserve( n );
+
+    std::mt19937 rng;
+
+    unsigned k = 0;
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        switch( d )
+        {
+        case uniform: k = rng() % 4; break;
+        case skewed: k = rng() % 10 == 0? rng() % 4: 0; break;
+        case runs: if( i % 16 == 0 ) k = rng() % 4; break;
+        case constant: k = 1; break;
+        }
+
+        float x = static_cast<float>( rng() % 100 );
+
+        switch( k )
+        {
+        case 0: v.push_back( A{ x } ); break;
+        case 1: v.push_back( B{ x, 0.5f } ); break;
+        case 2: v.push_back( C{ static_cast<int>( x ) } ); break;
+        case 3: v.push_back( D{ x * 0.25 } ); break;
+        }
+    }
+
+    return v;
+}
+
+template<class F> void test( char const* name, std::vector<V> const& v, F f )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    double s = 0;
+
+    for( int k = 0; k < 20; ++k )
+    {
+        s += f( v );
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::printf( "    %-20s %5lld ms (%.0f)\n", name, static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), s );
+}
+
+static void test( distribution d, char const* name, std::size_t n )
+{
+    std::printf( "%s:\n", name );
+
+    auto v = make( d, n );
+
+    test( "visit", v, []( std::vector<V> const& v ){
+
+        sum s;
+        for( auto const& x: v ) visit( s, x );
+        return s.s;
+
+    });
+
+    test( "visit_each", v, []( std::vector<V> const& v ){
+
+        return visit_each( v.begin(), v.end(), sum() ).s;
+
+    });
+
+    test( "visit_each_ordered", v, []( std::vector<V> const& v ){
+
+        return visit_each_ordered( v.begin(), v.end(), sum() ).s;
+
+    });
+}
+
+int main()
+{
+    std::size_t const n = 4 * 1024 * 1024;
+
+    test( uniform, "uniform over 4 alternatives", n );
+    test( skewed, "90% one alternative", n );
+    test( runs, "runs of 16", n );
+    test( constant, "one alternative", n );
+}
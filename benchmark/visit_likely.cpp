@@ -0,0 +1,89 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+// Routes a stream of messages, 96% of them trades, with visit and with
+// visit_likely<Trade>
+
+#include <boost/variant2/variant.hpp>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace boost::variant2;
+
+struct Heartbeat { unsigned seq; };
+struct Trade { unsigned px, qty; };
+struct Quote { unsigned bid, ask; };
+struct Admin { unsigned code; };
+struct Reject { unsigned code, reason; };
+struct Status { unsigned state; };
+
+using Message = variant<Heartbeat, Trade, Quote, Admin, Reject, Status>;
+
+struct router
+{
+    unsigned operator()( Heartbeat const& m ) const { return m.seq; }
+    unsigned operator()( Trade const& m ) const { return m.px * m.qty; }
+    unsigned operator()( Quote const& m ) const { return m.ask - m.bid; }
+    unsigned operator()( Admin const& m ) const { return m.code ^ 0x55; }
+    unsigned operator()( Reject const& m ) const { return m.code + m.reason * 7; }
+    unsigned operator()( Status const& m ) const { return m.state << 2; }
+};
+
+template<class F> void test( char const* name, std::vector<Message> const& v, F f )
+{
+    auto t1 = std::chrono::steady_clock::now();
+
+    unsigned s = 0;
+
+    for( int k = 0; k < 20; ++k )
+    {
+        for( auto const& m: v )
+        {
+            s += f( m );
+        }
+    }
+
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::printf( "%s: %lld ms (%u)\n", name, static_cast<long long>( std::chrono::duration_cast<std::chrono::milliseconds>( t2 - t1 ).count() ), s );
+}
+
+int main()
+{
+    std::size_t const n = 4 * 1024 * 1024;
+
+    std::vector<Message> v;
+    v.reserve( n );
+
+    std::mt19937 rng;
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        unsigned x = static_cast<unsigned>( rng() % 1000 );
+
+        if( rng() % 100 < 96 )
+        {
+            v.push_back( Trade{ x, x + 1 } );
+            continue;
+        }
+
+        switch( rng() % 5 )
+        {
+        case 0: v.push_back( Heartbeat{ x } ); break;
+        case 1: v.push_back( Quote{ x, x + 2 } ); break;
+        case 2: v.push_back( Admin{ x } ); break;
+        case 3: v.push_back( Reject{ x, x } ); break;
+        case 4: v.push_back( Status{ x } ); break;
+        }
+    }
+
+    test( "visit", v, []( Message const& m ){ return visit( router(), m ); } );
+    test( "visit_likely<Trade>", v, []( Message const& m ){ return visit_likely<Trade>( router(), m ); } );
+    test( "visit_likely<Trade, Quote>", v, []( Message const& m ){ return visit_likely<Trade, Quote>( router(), m ); } );
+}
@@ -0,0 +1,762 @@
+#ifndef BOOST_VARIANT2_ALGORITHM_HPP_INCLUDED
+#define BOOST_VARIANT2_ALGORITHM_HPP_INCLUDED
+
+//  Copyright 2017 Peter Dimov.
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#ifndef BOOST_VARIANT2_VARIANT_HPP_INCLUDED
+#include <boost/variant2/variant.hpp>
+#endif
+#include <boost/config.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+//
+
+#if !defined(BOOST_VARIANT2_NO_SIMD) && ( defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 ) )
+
+# define BOOST_VARIANT2_HAS_SSE2
+# include <emmintrin.h>
+
+# if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+# endif
+
+#endif
+
+#if defined(BOOST_VARIANT2_HAS_SSE2) && defined(__GNUC__) && !defined(BOOST_VARIANT2_NO_AVX2)
+
+// AVX2, selected at run time
+
+# define BOOST_VARIANT2_HAS_AVX2
+# include <immintrin.h>
+
+#endif
+
+namespace boost
+{
+namespace variant2
+{
+
+namespace detail
+{
+
+// visit_each_run
+//
+// Calls f on each element of [first, last), all of which hold the
+// alternative i, after a single dispatch on i
+
+template<class It, class F> void visit_each_run( It first, It last, std::size_t i, F& f )
+{
+    using V = decltype( *first );
+
+    dispatch_alternative<var_alternatives<V>>( i, [&]( auto I ){
+
+        for( ; first != last; ++first )
+        {
+            f( visit_get<I>( *first ) );
+        }
+
+    });
+}
+
+// visit_each_bucketed
+//
+// Sorts the elements of each chunk of [first, last) by alternative, with
+// a branchless counting sort of their offsets, and visits each bucket
+// after a single dispatch. Chunks made of long runs are visited a run at
+// a time instead
+
+template<class It, class F> void visit_each_bucketed( It first, It last, F& f, std::random_access_iterator_tag )
+{
+    using V = decltype( *first );
+
+    constexpr std::size_t N = var_size<V>::value;
+    constexpr std::size_t M = 256;
+
+    using index_type = smallest_unsigned_type<N>;
+
+    while( first != last )
+    {
+        std::size_t const m = last - first < static_cast<std::ptrdiff_t>( M )? static_cast<std::size_t>( last - first ): M;
+
+        index_type ix[ M ];
+
+        std::size_t changes = 0;
+
+        for( std::size_t k = 0; k < m; ++k )
+        {
+            ix[ k ] = static_cast<index_type>( visit_index( first[ k ] ) );
+            changes += k != 0 && ix[ k ] != ix[ k - 1 ];
+        }
+
+        if( changes * 4 <= m )
+        {
+            // long runs, visit them in place
+
+            for( std::size_t k = 0; k < m; )
+            {
+                std::size_t e = k + 1;
+
+                while( e < m && ix[ e ] == ix[ k ] ) ++e;
+
+                visit_each_run( first + k, first + e, ix[ k ], f );
+
+                k = e;
+            }
+
+            first += m;
+            continue;
+        }
+
+        std::size_t pos[ N + 1 ] = {};
+
+        for( std::size_t k = 0; k < m; ++k )
+        {
+            ++pos[ ix[ k ] + 1 ];
+        }
+
+        for( std::size_t j = 0; j < N; ++j )
+        {
+            pos[ j + 1 ] += pos[ j ];
+        }
+
+        unsigned char order[ M ];
+
+        {
+            std::size_t next[ N ];
+
+            for( std::size_t j = 0; j < N; ++j )
+            {
+                next[ j ] = pos[ j ];
+            }
+
+            for( std::size_t k = 0; k < m; ++k )
+            {
+                order[ next[ ix[ k ] ]++ ] = static_cast<unsigned char>( k );
+            }
+        }
+
+        for( std::size_t j = 0; j < N; ++j )
+        {
+            if( pos[ j ] == pos[ j + 1 ] ) continue;
+
+            dispatch_alternative<var_alternatives<V>>( j, [&]( auto I ){
+
+                for( std::size_t k = pos[ I ]; k < pos[ I + 1 ]; ++k )
+                {
+                    f( visit_get<I>( first[ order[ k ] ] ) );
+                }
+
+            });
+        }
+
+        first += m;
+    }
+}
+
+template<class It, class F> void visit_each_ordered_impl( It first, It last, F& f )
+{
+    // runs are capped so that they are still in cache when visited
+
+    constexpr std::size_t M = 256;
+
+    while( first != last )
+    {
+        std::size_t const i = visit_index( *first );
+
+        It next = first;
+        std::size_t n = 1;
+
+        for( ++next; next != last && n < M && visit_index( *next ) == i; ++next, ++n )
+        {
+        }
+
+        visit_each_run( first, next, i, f );
+
+        first = next;
+    }
+}
+
+template<class It, class F> void visit_each_bucketed( It first, It last, F& f, std::input_iterator_tag )
+{
+    visit_each_ordered_impl( first, last, f );
+}
+
+// index scanning
+//
+// Kernels that scan a compact stream of indices for the index x: counting
+// its occurrences, finding the first, or writing the positions of all of
+// them. Streams of bytes are compared 16 or 32 at a time when SSE2 or AVX2
+// is available; anything else, a byte at a time
+
+template<class X> std::size_t count_index( X const * p, std::size_t n, X x ) noexcept
+{
+    std::size_t r = 0;
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        r += p[ i ] == x;
+    }
+
+    return r;
+}
+
+template<class X> std::size_t find_index( X const * p, std::size_t n, X x ) noexcept
+{
+    std::size_t i = 0;
+
+    while( i < n && p[ i ] != x ) ++i;
+
+    return i;
+}
+
+template<class X, class Out> Out select_index( X const * p, std::size_t n, X x, std::size_t base, Out out )
+{
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        if( p[ i ] == x ) *out++ = base + i;
+    }
+
+    return out;
+}
+
+#if defined(BOOST_VARIANT2_HAS_SSE2)
+
+inline unsigned countr_zero( unsigned x ) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+
+    unsigned long r;
+    _BitScanForward( &r, x );
+    return static_cast<unsigned>( r );
+
+#else
+
+    return static_cast<unsigned>( __builtin_ctz( x ) );
+
+#endif
+}
+
+#endif
+
+#if defined(BOOST_VARIANT2_HAS_AVX2)
+
+inline bool has_avx2() noexcept
+{
+    static bool const r = __builtin_cpu_supports( "avx2" );
+    return r;
+}
+
+__attribute__(( __target__( "avx2" ) )) inline std::size_t count_index_avx2( unsigned char const * p, std::size_t n, unsigned char x ) noexcept
+{
+    __m256i const vx = _mm256_set1_epi8( static_cast<char>( x ) );
+    __m256i const zero = _mm256_setzero_si256();
+
+    __m256i sum = zero;
+
+    std::size_t i = 0;
+
+    while( n - i >= 32 )
+    {
+        // the byte counters in acc can't overflow in 255 iterations
+
+        std::size_t const e = i + ( n - i < 32 * 255? ( n - i ) / 32 * 32: 32 * 255 );
+
+        __m256i acc = zero;
+
+        for( ; i < e; i += 32 )
+        {
+            __m256i v = _mm256_loadu_si256( reinterpret_cast<__m256i const*>( p + i ) );
+            acc = _mm256_sub_epi8( acc, _mm256_cmpeq_epi8( v, vx ) );
+        }
+
+        sum = _mm256_add_epi64( sum, _mm256_sad_epu8( acc, zero ) );
+    }
+
+    alignas( 32 ) unsigned long long s[ 4 ];
+    _mm256_store_si256( reinterpret_cast<__m256i*>( s ), sum );
+
+    return static_cast<std::size_t>( s[ 0 ] + s[ 1 ] + s[ 2 ] + s[ 3 ] ) + count_index( p + i, n - i, x );
+}
+
+__attribute__(( __target__( "avx2" ) )) inline std::size_t find_index_avx2( unsigned char const * p, std::size_t n, unsigned char x ) noexcept
+{
+    __m256i const vx = _mm256_set1_epi8( static_cast<char>( x ) );
+
+    std::size_t i = 0;
+
+    for( ; n - i >= 32; i += 32 )
+    {
+        __m256i v = _mm256_loadu_si256( reinterpret_cast<__m256i const*>( p + i ) );
+        unsigned m = static_cast<unsigned>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( v, vx ) ) );
+
+        if( m ) return i + countr_zero( m );
+    }
+
+    return i + find_index( p + i, n - i, x );
+}
+
+template<class Out> __attribute__(( __target__( "avx2" ) )) Out select_index_avx2( unsigned char const * p, std::size_t n, unsigned char x, std::size_t base, Out out )
+{
+    __m256i const vx = _mm256_set1_epi8( static_cast<char>( x ) );
+
+    std::size_t i = 0;
+
+    for( ; n - i >= 32; i += 32 )
+    {
+        __m256i v = _mm256_loadu_si256( reinterpret_cast<__m256i const*>( p + i ) );
+
+        for( unsigned m = static_cast<unsigned>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( v, vx ) ) ); m; m &= m - 1 )
+        {
+            *out++ = base + i + countr_zero( m );
+        }
+    }
+
+    return select_index( p + i, n - i, x, base + i, out );
+}
+
+#endif
+
+#if defined(BOOST_VARIANT2_HAS_SSE2)
+
+inline std::size_t count_index( unsigned char const * p, std::size_t n, unsigned char x ) noexcept
+{
+#if defined(BOOST_VARIANT2_HAS_AVX2)
+
+    if( has_avx2() ) return count_index_avx2( p, n, x );
+
+#endif
+
+    __m128i const vx = _mm_set1_epi8( static_cast<char>( x ) );
+    __m128i const zero = _mm_setzero_si128();
+
+    __m128i sum = zero;
+
+    std::size_t i = 0;
+
+    while( n - i >= 16 )
+    {
+        // the byte counters in acc can't overflow in 255 iterations
+
+        std::size_t const e = i + ( n - i < 16 * 255? ( n - i ) / 16 * 16: 16 * 255 );
+
+        __m128i acc = zero;
+
+        for( ; i < e; i += 16 )
+        {
+            __m128i v = _mm_loadu_si128( reinterpret_cast<__m128i const*>( p + i ) );
+            acc = _mm_sub_epi8( acc, _mm_cmpeq_epi8( v, vx ) );
+        }
+
+        sum = _mm_add_epi64( sum, _mm_sad_epu8( acc, zero ) );
+    }
+
+    // each 64 bit lane of sum holds a partial count, which only fits in
+    // 32 bits when std::size_t does
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+    std::size_t r = static_cast<std::size_t>( _mm_cvtsi128_si64( sum ) ) + static_cast<std::size_t>( _mm_cvtsi128_si64( _mm_srli_si128( sum, 8 ) ) );
+
+#else
+
+    std::size_t r = static_cast<std::size_t>( _mm_cvtsi128_si32( sum ) ) + static_cast<std::size_t>( _mm_cvtsi128_si32( _mm_srli_si128( sum, 8 ) ) );
+
+#endif
+
+    return r + count_index<unsigned char>( p + i, n - i, x );
+}
+
+inline std::size_t find_index( unsigned char const * p, std::size_t n, unsigned char x ) noexcept
+{
+#if defined(BOOST_VARIANT2_HAS_AVX2)
+
+    if( has_avx2() ) return find_index_avx2( p, n, x );
+
+#endif
+
+    __m128i const vx = _mm_set1_epi8( static_cast<char>( x ) );
+
+    std::size_t i = 0;
+
+    for( ; n - i >= 16; i += 16 )
+    {
+        __m128i v = _mm_loadu_si128( reinterpret_cast<__m128i const*>( p + i ) );
+        unsigned m = static_cast<unsigned>( _mm_movemask_epi8( _mm_cmpeq_epi8( v, vx ) ) );
+
+        if( m ) return i + countr_zero( m );
+    }
+
+    return i + find_index<unsigned char>( p + i, n - i, x );
+}
+
+template<class Out> Out select_index( unsigned char const * p, std::size_t n, unsigned char x, std::size_t base, Out out )
+{
+#if defined(BOOST_VARIANT2_HAS_AVX2)
+
+    if( has_avx2() ) return select_index_avx2( p, n, x, base, out );
+
+#endif
+
+    __m128i const vx = _mm_set1_epi8( static_cast<char>( x ) );
+
+    std::size_t i = 0;
+
+    for( ; n - i >= 16; i += 16 )
+    {
+        __m128i v = _mm_loadu_si128( reinterpret_cast<__m128i const*>( p + i ) );
+
+        for( unsigned m = static_cast<unsigned>( _mm_movemask_epi8( _mm_cmpeq_epi8( v, vx ) ) ); m; m &= m - 1 )
+        {
+            *out++ = base + i + countr_zero( m );
+        }
+    }
+
+    return select_index<unsigned char>( p + i, n - i, x, base + i, out );
+}
+
+#endif
+
+// hash_range_impl
+
+constexpr std::uint64_t hash_range_k = 0x100000001B3ull;
+
+inline std::uint64_t hash_range_term( std::size_t i, std::size_t h ) noexcept
+{
+    std::uint64_t x = static_cast<std::uint64_t>( h ) ^ ( static_cast<std::uint64_t>( i + 1 ) * 0x9E3779B97F4A7C15ull );
+
+    x ^= x >> 32;
+    x *= 0xD6E8FEB86659FD93ull;
+    x ^= x >> 32;
+
+    return x;
+}
+
+// hashes [first, last) into h a run at a time; returns the number of runs
+
+template<class It> std::size_t hash_range_runs( It first, It last, std::uint64_t & h )
+{
+    using V = decltype( *first );
+
+    std::size_t runs = 0;
+
+    for( ; first != last; ++runs )
+    {
+        dispatch_alternative<var_alternatives<V>>( visit_index( *first ), [&]( auto I ){
+
+            do
+            {
+                h = h * hash_range_k + hash_range_term( I, hash_alternative( visit_get<I>( *first ) ) );
+                ++first;
+            }
+            while( first != last && visit_index( *first ) == I );
+
+        });
+    }
+
+    return runs;
+}
+
+template<class It> std::uint64_t hash_range_impl( It first, It last, std::input_iterator_tag )
+{
+    std::uint64_t h = 0;
+
+    hash_range_runs( first, last, h );
+
+    return h;
+}
+
+template<class It> std::uint64_t hash_range_impl( It first, It last, std::random_access_iterator_tag )
+{
+    using V = decltype( *first );
+
+    constexpr std::size_t N = var_size<V>::value;
+    constexpr std::size_t M = 256;
+
+    using index_type = smallest_unsigned_type<N>;
+
+    // pw[ k ] is K^k
+
+    std::uint64_t pw[ M + 1 ];
+
+    pw[ 0 ] = 1;
+
+    for( std::size_t k = 0; k < M; ++k )
+    {
+        pw[ k + 1 ] = pw[ k ] * hash_range_k;
+    }
+
+    std::uint64_t h = 0;
+
+    // whether the previous chunk had short runs
+
+    bool short_runs = false;
+
+    while( first != last )
+    {
+        std::size_t const m = last - first < static_cast<std::ptrdiff_t>( M )? static_cast<std::size_t>( last - first ): M;
+
+        if( !short_runs )
+        {
+            short_runs = hash_range_runs( first, first + m, h ) * 2 > m;
+
+            first += m;
+            continue;
+        }
+
+        index_type ix[ M ];
+        std::size_t pos[ N + 1 ] = {};
+
+        std::size_t runs = 1;
+
+        for( std::size_t k = 0; k < m; ++k )
+        {
+            ix[ k ] = static_cast<index_type>( visit_index( first[ k ] ) );
+            ++pos[ ix[ k ] + 1 ];
+            runs += k != 0 && ix[ k ] != ix[ k - 1 ];
+        }
+
+        short_runs = runs * 2 > m;
+
+        for( std::size_t j = 0; j < N; ++j )
+        {
+            pos[ j + 1 ] += pos[ j ];
+        }
+
+        unsigned char order[ M ];
+
+        {
+            std::size_t next[ N ];
+
+            for( std::size_t j = 0; j < N; ++j )
+            {
+                next[ j ] = pos[ j ];
+            }
+
+            for( std::size_t k = 0; k < m; ++k )
+            {
+                order[ next[ ix[ k ] ]++ ] = static_cast<unsigned char>( k );
+            }
+        }
+
+        std::uint64_t s = 0;
+
+        for( std::size_t j = 0; j < N; ++j )
+        {
+            if( pos[ j ] == pos[ j + 1 ] ) continue;
+
+            dispatch_alternative<var_alternatives<V>>( j, [&]( auto I ){
+
+                for( std::size_t k = pos[ I ]; k < pos[ I + 1 ]; ++k )
+                {
+                    std::size_t const p = order[ k ];
+                    s += hash_range_term( I, hash_alternative( visit_get<I>( first[ p ] ) ) ) * pw[ m - 1 - p ];
+                }
+
+            });
+        }
+
+        h = h * pw[ m ] + s;
+
+        first += m;
+    }
+
+    return h;
+}
+
+// equal_range_runs
+//
+// Compares the elements of [first1, last1) with those starting at first2,
+// dispatching once per run of elements holding the same alternative
+
+template<class It1, class It2> bool equal_range_runs( It1 first1, It1 last1, It2 first2 )
+{
+    using V = decltype( *first1 );
+
+    while( first1 != last1 )
+    {
+        std::size_t i = visit_index( *first1 );
+
+        if( visit_index( *first2 ) != i ) return false;
+
+        bool r = dispatch_alternative<var_alternatives<V>>( i, [&]( auto I ){
+
+            do
+            {
+                if( !( visit_get<I>( *first1 ) == visit_get<I>( *first2 ) ) ) return false;
+
+                ++first1;
+                ++first2;
+            }
+            while( first1 != last1 && visit_index( *first1 ) == I && visit_index( *first2 ) == I );
+
+            return true;
+
+        });
+
+        if( !r ) return false;
+    }
+
+    return true;
+}
+
+// variants whose equality needs no dispatch are compared element by element
+
+template<class V> struct is_bitwise_comparable_element: mp_false
+{
+};
+
+template<class... T> struct is_bitwise_comparable_element<variant<T...>>: is_bitwise_comparable_variant<T...>
+{
+};
+
+template<class It1, class It2> bool equal_range_impl( It1 first1, It1 last1, It2 first2, mp_false )
+{
+    return equal_range_runs( first1, last1, first2 );
+}
+
+template<class It1, class It2> bool equal_range_impl( It1 first1, It1 last1, It2 first2, mp_true )
+{
+    for( ; first1 != last1; ++first1, ++first2 )
+    {
+        if( !( *first1 == *first2 ) ) return false;
+    }
+
+    return true;
+}
+
+template<class It, class U> using alternative_index = mp_find<var_alternatives<decltype( *std::declval<It>() )>, U>;
+
+template<class It, class U> void check_alternative() noexcept
+{
+    static_assert( mp_count<var_alternatives<decltype( *std::declval<It>() )>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+}
+
+} // namespace detail
+
+// count_alternative
+//
+// Returns the number of elements of [first, last) holding the alternative U
+
+template<class U, class It> std::size_t count_alternative( It first, It last )
+{
+    variant2::detail::check_alternative<It, U>();
+
+    std::size_t r = 0;
+
+    for( ; first != last; ++first )
+    {
+        r += variant2::detail::visit_index( *first ) == variant2::detail::alternative_index<It, U>::value;
+    }
+
+    return r;
+}
+
+// find_alternative
+//
+// Returns an iterator to the first element of [first, last) holding the
+// alternative U, or last
+
+template<class U, class It> It find_alternative( It first, It last )
+{
+    variant2::detail::check_alternative<It, U>();
+
+    while( first != last && variant2::detail::visit_index( *first ) != variant2::detail::alternative_index<It, U>::value )
+    {
+        ++first;
+    }
+
+    return first;
+}
+
+// select_alternative
+//
+// Writes to out the positions, relative to first, of the elements of
+// [first, last) holding the alternative U, in increasing order
+
+template<class U, class It, class Out> Out select_alternative( It first, It last, Out out )
+{
+    variant2::detail::check_alternative<It, U>();
+
+    for( std::size_t i = 0; first != last; ++first, ++i )
+    {
+        if( variant2::detail::visit_index( *first ) == variant2::detail::alternative_index<It, U>::value )
+        {
+            *out++ = i;
+        }
+    }
+
+    return out;
+}
+
+// hash_range
+//
+// Returns a hash of the sequence of variants [first, last), the polynomial
+// e1 * K^(n-1) + e2 * K^(n-2) + ... + en, where ei mixes the index and the
+// std::hash of the alternative of the i-th element. Throws
+// bad_variant_access if an element is valueless.
+//
+// The dispatch on the index is done once per run of elements holding the
+// same alternative. Since the terms are independent, for random access
+// ranges, chunks of 256 elements following a chunk with short runs are
+// instead bucketed by alternative, as in visit_each, and each bucket is
+// hashed after a single dispatch
+
+template<class It> std::size_t hash_range( It first, It last )
+{
+    return static_cast<std::size_t>( variant2::detail::hash_range_impl( first, last, typename std::iterator_traits<It>::iterator_category() ) );
+}
+
+// equal_range_of_variants
+//
+// Returns whether the elements of [first1, last1) are equal to the elements
+// of the range of the same length starting at first2, comparing the indices
+// and then the alternatives, with a single dispatch per run of elements
+// holding the same alternative. Variants of bitwise comparable alternatives
+// are compared with operator==, which needs no dispatch. Throws
+// bad_variant_access if an element is valueless
+
+template<class It1, class It2> bool equal_range_of_variants( It1 first1, It1 last1, It2 first2 )
+{
+    using V1 = std::remove_cv_t<std::remove_reference_t<decltype( *first1 )>>;
+    using V2 = std::remove_cv_t<std::remove_reference_t<decltype( *first2 )>>;
+
+    return variant2::detail::equal_range_impl( first1, last1, first2, mp_bool<std::is_same<V1, V2>::value && variant2::detail::is_bitwise_comparable_element<V1>::value>() );
+}
+
+// visit_each_ordered
+//
+// Calls f on the alternative held by each element of [first, last), in
+// order, dispatching once per run of elements holding the same alternative
+
+template<class It, class F> F visit_each_ordered( It first, It last, F f )
+{
+    variant2::detail::visit_each_ordered_impl( first, last, f );
+    return f;
+}
+
+// visit_each
+//
+// Calls f on the alternative held by each element of [first, last), in
+// an unspecified order. For random access iterators, the elements are
+// grouped by alternative in chunks of 256 and each group is visited after
+// a single dispatch; otherwise, this is visit_each_ordered
+
+template<class It, class F> F visit_each( It first, It last, F f )
+{
+    variant2::detail::visit_each_bucketed( first, last, f, typename std::iterator_traits<It>::iterator_category() );
+    return f;
+}
+
+} // namespace variant2
+} // namespace boost
+
+#endif // #ifndef BOOST_VARIANT2_ALGORITHM_HPP_INCLUDED
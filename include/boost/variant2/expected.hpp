@@ -124,6 +124,10 @@ private:
 
     variant<T, E...> v_;
 
+    template<class T2, class... E2> friend constexpr bool operator==( expected<T2, E2...> const & x1, expected<T2, E2...> const & x2 );
+    template<class T2, class... E2> friend constexpr bool operator!=( expected<T2, E2...> const & x1, expected<T2, E2...> const & x2 );
+    template<class T2, class... E2> friend std::size_t hash_value( expected<T2, E2...> const & x );
+
 private:
 
     void _bad_access() const
@@ -160,6 +164,13 @@ public:
     {
     }
 
+    // constructs the value from the result of f(); since C++17, it isn't moved
+
+    template<class F, class En = std::enable_if_t<variant2::detail::is_factory_constructible<T, variant2::detail::factory_result<F>>::value>>
+    constexpr expected( in_place_factory_t, F&& f ): v_( in_place_factory, [&]() -> T { return std::forward<F>(f)(); } )
+    {
+    }
+
     // template<class U> constexpr expected( U && u ); where U in E...?
 
     // in-place constructor?
@@ -204,6 +215,16 @@ public:
         v_.emplace( il, std::forward<A>(a)... );
     }
 
+    // emplaces the value from the result of f(); since C++17, a prvalue T
+    // is constructed in place, unless a temporary is needed to keep the old
+    // state if f throws
+
+    template<class F, class En = std::enable_if_t<variant2::detail::is_factory_constructible<T, variant2::detail::factory_result<F>>::value>>
+    T& emplace_with( F&& f )
+    {
+        return v_.template emplace_with<0>( std::forward<F>(f) );
+    }
+
     // swap
 
     void swap( expected & r ) noexcept( noexcept( v_.swap( r.v_ ) ) )
@@ -440,7 +461,23 @@ template<class T, class... E> inline void swap( expected<T, E...> & x1, expected
     x1.swap( x2 );
 }
 
+template<class T, class... E> std::size_t hash_value( expected<T, E...> const & x )
+{
+    return hash_value( x.v_ );
+}
+
 } // namespace variant2
 } // namespace boost
 
+// std::hash
+
+namespace std
+{
+
+template<class T, class... E> struct hash<::boost::variant2::expected<T, E...>>: ::boost::variant2::detail::hash_base<::boost::variant2::expected<T, E...>, ::boost::variant2::detail::is_hash_enabled<T, E...>>
+{
+};
+
+} // namespace std
+
 #endif // #ifndef BOOST_VARIANT2_EXPECTED_HPP_INCLUDED
@@ -0,0 +1,414 @@
+#ifndef BOOST_VARIANT2_NAN_VARIANT_HPP_INCLUDED
+#define BOOST_VARIANT2_NAN_VARIANT_HPP_INCLUDED
+
+//  Copyright 2017 Peter Dimov.
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#ifndef BOOST_VARIANT2_VARIANT_HPP_INCLUDED
+#include <boost/variant2/variant.hpp>
+#endif
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <cassert>
+#include <utility>
+
+//
+
+namespace boost
+{
+namespace variant2
+{
+
+// nan_variant forward declaration
+
+template<class... T> class nan_variant;
+
+// variant_size
+
+template<class... T> struct variant_size<nan_variant<T...>>: mp_size<nan_variant<T...>>
+{
+};
+
+// variant_alternative
+
+template<std::size_t I, class... T> struct variant_alternative<I, nan_variant<T...>>: mp_defer<mp_at, nan_variant<T...>, mp_size_t<I>>
+{
+};
+
+namespace detail
+{
+
+// nan_box_*
+//
+// A double is stored as is, except that NaNs are canonicalized to a single
+// positive quiet NaN; all other alternatives are stored as a negative quiet
+// NaN, with the alternative number in the three bits below the quiet bit
+// and the value in the low 48 bits:
+//
+//     1 11111111111 1 kkk vvvv...vvvv (48 bits)
+
+template<class T> using is_nan_box_empty = mp_bool<std::is_empty<T>::value && std::is_trivially_default_constructible<T>::value>;
+
+template<class T> using is_nan_box_integral = mp_bool<( std::is_integral<T>::value || std::is_enum<T>::value ) && sizeof(T) <= 4>;
+
+template<class T> using is_nan_box_pointer = mp_bool<std::is_pointer<T>::value && sizeof(T) <= 8>;
+
+template<class T> using is_nan_boxable = mp_bool<is_nan_box_empty<T>::value || is_nan_box_integral<T>::value || is_nan_box_pointer<T>::value>;
+
+constexpr std::uint64_t nan_box_tag = 0xFFF8000000000000ull;
+constexpr std::uint64_t nan_box_canonical_nan = 0x7FF8000000000000ull;
+constexpr std::uint64_t nan_box_payload_mask = 0x0000FFFFFFFFFFFFull;
+
+template<class T> struct nan_box_integral_rep: std::make_unsigned<T>
+{
+};
+
+template<> struct nan_box_integral_rep<bool>
+{
+    using type = bool;
+};
+
+template<class T> using nan_box_rep = typename nan_box_integral_rep<mp_eval_if<mp_not<std::is_enum<T>>, T, std::underlying_type_t, T>>::type;
+
+template<class T> std::uint64_t nan_box_encode( mp_size_t<0>, T const& ) noexcept // empty
+{
+    return 0;
+}
+
+template<class T> std::uint64_t nan_box_encode( mp_size_t<1>, T const& v ) noexcept // integral or enum
+{
+    return static_cast<nan_box_rep<T>>( v );
+}
+
+template<class T> std::uint64_t nan_box_encode( mp_size_t<2>, T const& v ) noexcept // pointer
+{
+    std::uint64_t const p = reinterpret_cast<std::uintptr_t>( v );
+
+    assert( ( p & ~nan_box_payload_mask ) == 0 );
+
+    return p;
+}
+
+template<class T> T nan_box_decode( mp_size_t<0>, std::uint64_t ) noexcept
+{
+    return T();
+}
+
+template<class T> T nan_box_decode( mp_size_t<1>, std::uint64_t p ) noexcept
+{
+    return static_cast<T>( static_cast<nan_box_rep<T>>( p ) );
+}
+
+template<class T> T nan_box_decode( mp_size_t<2>, std::uint64_t p ) noexcept
+{
+    return reinterpret_cast<T>( static_cast<std::uintptr_t>( p ) );
+}
+
+template<class T> using nan_box_kind = mp_size_t<is_nan_box_empty<T>::value? 0: is_nan_box_integral<T>::value? 1: 2>;
+
+} // namespace detail
+
+// nan_variant
+//
+// A pointer alternative is stored in 48 bits. The pointers stored must fit
+// in them, as user space addresses do on current 64 bit platforms with
+// four level page tables; this is checked only by an assertion
+
+template<class... T> class nan_variant
+{
+private:
+
+    static constexpr std::size_t D = mp_find<nan_variant<T...>, double>::value;
+
+    static_assert( std::numeric_limits<double>::is_iec559 && sizeof(double) == sizeof(std::uint64_t), "nan_variant requires IEEE 754 doubles" );
+    static_assert( mp_count<nan_variant<T...>, double>::value == 1, "nan_variant requires exactly one double alternative" );
+    static_assert( sizeof...(T) <= 9, "nan_variant supports at most eight alternatives besides double" );
+    static_assert( mp_all<mp_or<std::is_same<T, double>, variant2::detail::is_nan_boxable<T>>...>::value, "The alternatives of nan_variant other than double must be empty types, integral or enumeration types of at most 32 bits, or pointers" );
+
+    std::uint64_t w_;
+
+    // alternative I, I != D, is boxed with the number I or I-1
+
+    static constexpr std::uint64_t _tag( std::size_t i ) noexcept
+    {
+        return variant2::detail::nan_box_tag | static_cast<std::uint64_t>( i < D? i: i - 1 ) << 48;
+    }
+
+    static std::uint64_t _encode( mp_size_t<D>, double v ) noexcept
+    {
+        std::uint64_t w;
+
+        if( v != v )
+        {
+            w = variant2::detail::nan_box_canonical_nan;
+        }
+        else
+        {
+            std::memcpy( &w, &v, sizeof(w) );
+        }
+
+        return w;
+    }
+
+    template<std::size_t I, class U> static std::uint64_t _encode( mp_size_t<I>, U const& v ) noexcept
+    {
+        using V = mp_at_c<nan_variant<T...>, I>;
+        return _tag( I ) | variant2::detail::nan_box_encode<V>( variant2::detail::nan_box_kind<V>(), v );
+    }
+
+public:
+
+    // constructors
+
+    nan_variant() noexcept: w_( _encode( mp_size_t<0>(), mp_first<nan_variant<T...>>() ) )
+    {
+    }
+
+    template<class U,
+        class Ud = std::decay_t<U>,
+        class E1 = std::enable_if_t< !std::is_same<Ud, nan_variant>::value && !variant2::detail::is_in_place_index<Ud>::value && !variant2::detail::is_in_place_type<Ud>::value >,
+        class V = variant2::detail::resolve_overload_type<U&&, T...>,
+        class E2 = std::enable_if_t<std::is_constructible<V, U>::value>
+        >
+    nan_variant( U&& u ) noexcept
+        : w_( _encode( variant2::detail::resolve_overload_index<U&&, T...>(), V( std::forward<U>(u) ) ) )
+    {
+    }
+
+    template<class U, class... A, class I = mp_find<nan_variant<T...>, U>, class E = std::enable_if_t<std::is_constructible<U, A...>::value>>
+    explicit nan_variant( in_place_type_t<U>, A&&... a ): w_( _encode( I(), U( std::forward<A>(a)... ) ) )
+    {
+    }
+
+    template<std::size_t I, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<nan_variant<T...>, I>, A...>::value>>
+    explicit nan_variant( in_place_index_t<I>, A&&... a ): w_( _encode( mp_size_t<I>(), mp_at_c<nan_variant<T...>, I>( std::forward<A>(a)... ) ) )
+    {
+    }
+
+    // assignment
+
+    template<class U,
+        class E1 = std::enable_if_t<!std::is_same<std::decay_t<U>, nan_variant>::value>,
+        class V = variant2::detail::resolve_overload_type<U, T...>,
+        class E2 = std::enable_if_t<std::is_constructible<V, U>::value>
+    >
+    nan_variant& operator=( U&& u ) noexcept
+    {
+        w_ = _encode( variant2::detail::resolve_overload_index<U, T...>(), V( std::forward<U>(u) ) );
+        return *this;
+    }
+
+    // modifiers
+
+    template<class U, class... A, class I = mp_find<nan_variant<T...>, U>, class E = std::enable_if_t<std::is_constructible<U, A...>::value>>
+    U emplace( A&&... a )
+    {
+        U v( std::forward<A>(a)... );
+        w_ = _encode( I(), v );
+        return v;
+    }
+
+    template<std::size_t I, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<nan_variant<T...>, I>, A...>::value>>
+    mp_at_c<nan_variant<T...>, I> emplace( A&&... a )
+    {
+        mp_at_c<nan_variant<T...>, I> v( std::forward<A>(a)... );
+        w_ = _encode( mp_size_t<I>(), v );
+        return v;
+    }
+
+    // value status
+
+    constexpr std::size_t index() const noexcept
+    {
+        return w_ < variant2::detail::nan_box_tag? D: _unbox_index( ( w_ >> 48 ) & 7 );
+    }
+
+private:
+
+    static constexpr std::size_t _unbox_index( std::size_t k ) noexcept
+    {
+        return k < D? k: k + 1;
+    }
+
+public:
+
+    // swap
+
+    void swap( nan_variant& r ) noexcept
+    {
+        std::swap( w_, r.w_ );
+    }
+
+    // private accessors
+
+    constexpr std::uint64_t _real_index() const noexcept
+    {
+        return w_;
+    }
+
+    double _get_impl( mp_size_t<D> ) const noexcept
+    {
+        assert( index() == D );
+
+        double v;
+        std::memcpy( &v, &w_, sizeof(v) );
+
+        return v;
+    }
+
+    template<std::size_t I> mp_at_c<nan_variant<T...>, I> _get_impl( mp_size_t<I> ) const noexcept
+    {
+        assert( index() == I );
+
+        using V = mp_at_c<nan_variant<T...>, I>;
+        return variant2::detail::nan_box_decode<V>( variant2::detail::nan_box_kind<V>(), w_ & variant2::detail::nan_box_payload_mask );
+    }
+};
+
+// holds_alternative
+
+template<class U, class... T> constexpr bool holds_alternative( nan_variant<T...> const& v ) noexcept
+{
+    static_assert( mp_count<nan_variant<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    return v.index() == mp_find<nan_variant<T...>, U>::value;
+}
+
+// get (index)
+//
+// The alternatives are not stored as such, so get returns them by value
+
+template<std::size_t I, class... T> variant_alternative_t<I, nan_variant<T...>> get( nan_variant<T...> const& v )
+{
+    static_assert( I < sizeof...(T), "Index out of bounds" );
+
+    if( v.index() != I ) throw bad_variant_access();
+    return v._get_impl( mp_size_t<I>() );
+}
+
+// get (type)
+
+template<class U, class... T> U get( nan_variant<T...> const& v )
+{
+    static_assert( mp_count<nan_variant<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    constexpr auto I = mp_find<nan_variant<T...>, U>::value;
+
+    if( v.index() != I ) throw bad_variant_access();
+    return v._get_impl( mp_size_t<I>() );
+}
+
+// get_if
+//
+// As for ptr_variant, returns an alternative_value holding the alternative
+// when *v holds it, and an empty one otherwise
+
+template<std::size_t I, class... T> alternative_value<variant_alternative_t<I, nan_variant<T...>>> get_if( nan_variant<T...> const * v ) noexcept
+{
+    static_assert( I < sizeof...(T), "Index out of bounds" );
+    using R = alternative_value<variant_alternative_t<I, nan_variant<T...>>>;
+
+    return v && v->index() == I? R( v->_get_impl( mp_size_t<I>() ) ): R();
+}
+
+template<class U, class... T> alternative_value<U> get_if( nan_variant<T...> const * v ) noexcept
+{
+    static_assert( mp_count<nan_variant<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    constexpr auto I = mp_find<nan_variant<T...>, U>::value;
+
+    return v && v->index() == I? alternative_value<U>( v->_get_impl( mp_size_t<I>() ) ): alternative_value<U>();
+}
+
+// relational operators
+
+template<class... T> bool operator==( nan_variant<T...> const & v, nan_variant<T...> const & w )
+{
+    if( v.index() != w.index() ) return false;
+
+    return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+        return v._get_impl( I ) == w._get_impl( I );
+
+    });
+}
+
+template<class... T> bool operator!=( nan_variant<T...> const & v, nan_variant<T...> const & w )
+{
+    if( v.index() != w.index() ) return true;
+
+    return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+        return v._get_impl( I ) != w._get_impl( I );
+
+    });
+}
+
+template<class... T> bool operator<( nan_variant<T...> const & v, nan_variant<T...> const & w )
+{
+    if( v.index() < w.index() ) return true;
+    if( v.index() > w.index() ) return false;
+
+    return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+        return v._get_impl( I ) < w._get_impl( I );
+
+    });
+}
+
+template<class... T> bool operator>( nan_variant<T...> const & v, nan_variant<T...> const & w )
+{
+    if( v.index() > w.index() ) return true;
+    if( v.index() < w.index() ) return false;
+
+    return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+        return v._get_impl( I ) > w._get_impl( I );
+
+    });
+}
+
+template<class... T> bool operator<=( nan_variant<T...> const & v, nan_variant<T...> const & w )
+{
+    if( v.index() < w.index() ) return true;
+    if( v.index() > w.index() ) return false;
+
+    return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+        return v._get_impl( I ) <= w._get_impl( I );
+
+    });
+}
+
+template<class... T> bool operator>=( nan_variant<T...> const & v, nan_variant<T...> const & w )
+{
+    if( v.index() > w.index() ) return true;
+    if( v.index() < w.index() ) return false;
+
+    return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+        return v._get_impl( I ) >= w._get_impl( I );
+
+    });
+}
+
+// visitation
+//
+// visit() works with nan_variant through variant_size, variant_alternative
+// and get, with the alternatives passed by value
+
+// specialized algorithms
+
+template<class... T> void swap( nan_variant<T...> & v, nan_variant<T...> & w ) noexcept
+{
+    v.swap( w );
+}
+
+} // namespace variant2
+} // namespace boost
+
+#endif // #ifndef BOOST_VARIANT2_NAN_VARIANT_HPP_INCLUDED
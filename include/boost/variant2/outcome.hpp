@@ -69,6 +69,8 @@ private:
 
     variant<T, std::error_code, std::exception_ptr> v_;
 
+    template<class T2> friend std::size_t hash_value( outcome<T2> const & x );
+
 public:
 
     // constructors
@@ -227,22 +229,22 @@ public:
 
     void set_value( T const& t ) noexcept( std::is_nothrow_copy_constructible<T>::value )
     {
-        v_.emplace<0>( t );
+        v_.template emplace<0>( t );
     }
 
     void set_value( T&& t ) noexcept( std::is_nothrow_move_constructible<T>::value )
     {
-        v_.emplace<0>( std::move( t ) );
+        v_.template emplace<0>( std::move( t ) );
     }
 
     void set_error( std::error_code const & e ) noexcept
     {
-        v_.emplace<1>( e );
+        v_.template emplace<1>( e );
     }
 
     void set_exception( std::exception_ptr const & x ) noexcept
     {
-        v_.emplace<2>( x );
+        v_.template emplace<2>( x );
     }
 
     // swap
@@ -253,7 +255,29 @@ public:
     }
 };
 
+template<class T> std::size_t hash_value( outcome<T> const & x )
+{
+    // std::exception_ptr has no std::hash; all exceptions hash alike
+
+    return x.has_exception()? variant2::detail::hash_mix( 2, 0 ): variant2::detail::dispatch_index<2>( x.v_.index(), [&]( auto I ){
+
+        return variant2::detail::hash_mix( I, variant2::detail::hash_alternative( get<I>( x.v_ ) ) );
+
+    });
+}
+
 } // namespace variant2
 } // namespace boost
 
+// std::hash
+
+namespace std
+{
+
+template<class T> struct hash<::boost::variant2::outcome<T>>: ::boost::variant2::detail::hash_base<::boost::variant2::outcome<T>, ::boost::variant2::detail::is_hash_enabled<T>>
+{
+};
+
+} // namespace std
+
 #endif // #ifndef BOOST_VARIANT2_OUTCOME_HPP_INCLUDED
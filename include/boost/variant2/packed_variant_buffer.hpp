@@ -0,0 +1,673 @@
+#ifndef BOOST_VARIANT2_PACKED_VARIANT_BUFFER_HPP_INCLUDED
+#define BOOST_VARIANT2_PACKED_VARIANT_BUFFER_HPP_INCLUDED
+
+//  Copyright 2017 Peter Dimov.
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#ifndef BOOST_VARIANT2_VARIANT_HPP_INCLUDED
+#include <boost/variant2/variant.hpp>
+#endif
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <cassert>
+#include <utility>
+
+//
+
+namespace boost
+{
+namespace variant2
+{
+
+// forward declarations
+
+template<class... T> class packed_variant_buffer;
+template<bool C, class... T> class packed_variant_reference;
+template<bool C, class... T> class packed_variant_iterator;
+
+// variant_size
+
+template<bool C, class... T> struct variant_size<packed_variant_reference<C, T...>>: mp_size<mp_list<T...>>
+{
+};
+
+// variant_alternative
+
+template<std::size_t I, class... T> struct variant_alternative<I, packed_variant_reference<false, T...>>: mp_defer<mp_at, mp_list<T...>, mp_size_t<I>>
+{
+};
+
+template<std::size_t I, class... T> struct variant_alternative<I, packed_variant_reference<true, T...>>: mp_defer<mp_at, mp_list<T const...>, mp_size_t<I>>
+{
+};
+
+namespace detail
+{
+
+// packed layout
+//
+// An element is its index, of type X, followed by the alternative T at the
+// next offset suitably aligned for it; the next element starts at the
+// next offset suitably aligned for X. Offsets are relative to a buffer
+// aligned for std::max_align_t.
+
+constexpr std::size_t packed_align_up( std::size_t n, std::size_t a ) noexcept
+{
+    return ( n + a - 1 ) / a * a;
+}
+
+template<class X, class T> constexpr std::size_t packed_payload( std::size_t o ) noexcept
+{
+    return packed_align_up( o + sizeof( X ), alignof( T ) );
+}
+
+template<class X, class T> constexpr std::size_t packed_next( std::size_t o ) noexcept
+{
+    return packed_align_up( packed_payload<X, T>( o ) + sizeof( T ), alignof( X ) );
+}
+
+template<class P> std::size_t packed_address( P * p ) noexcept
+{
+    return static_cast<std::size_t>( reinterpret_cast<std::uintptr_t>( p ) );
+}
+
+} // namespace detail
+
+// packed_variant_reference
+//
+// Refers to an element of a packed_variant_buffer; acts as a variant whose
+// alternatives can be accessed and modified, but not changed
+
+template<bool C, class... T> class packed_variant_reference
+{
+private:
+
+    friend class packed_variant_buffer<T...>;
+    friend class packed_variant_iterator<C, T...>;
+    friend class packed_variant_reference<!C, T...>;
+
+    using index_type = variant2::detail::smallest_unsigned_type<sizeof...(T)>;
+    using byte_type = mp_if_c<C, unsigned char const, unsigned char>;
+
+    byte_type * p_;
+
+    explicit packed_variant_reference( byte_type * p ) noexcept: p_( p )
+    {
+    }
+
+public:
+
+    packed_variant_reference( packed_variant_reference const& ) = default;
+
+    template<bool C2, class E = std::enable_if_t<C && !C2>> packed_variant_reference( packed_variant_reference<C2, T...> const& r ) noexcept: p_( r.p_ )
+    {
+    }
+
+    // the alternative of the element can't be changed, and rebinding the
+    // reference would make *it = *jt a silent no-op
+
+    packed_variant_reference& operator=( packed_variant_reference const& ) = delete;
+
+    // value status
+
+    std::size_t index() const noexcept
+    {
+        index_type ix;
+        std::memcpy( &ix, p_, sizeof( ix ) );
+        return ix;
+    }
+
+    // conversion
+
+    operator variant<T...>() const
+    {
+        return variant2::detail::dispatch_index<sizeof...(T)>( index(), [&]( auto I ){
+
+            return variant<T...>( in_place_index_t<I>(), _get_impl( I ) );
+
+        });
+    }
+
+    // private accessors
+
+    template<std::size_t I> variant_alternative_t<I, packed_variant_reference> & _get_impl( mp_size_t<I> ) const noexcept
+    {
+        using U = mp_at_c<mp_list<T...>, I>;
+
+        assert( index() == I );
+
+        std::size_t a = variant2::detail::packed_address( p_ );
+        return *static_cast<U*>( static_cast<void*>( const_cast<unsigned char*>( p_ ) + ( variant2::detail::packed_payload<index_type, U>( a ) - a ) ) );
+    }
+};
+
+// packed_variant_iterator
+//
+// A forward iterator whose reference type is packed_variant_reference
+
+template<bool C, class... T> class packed_variant_iterator
+{
+private:
+
+    friend class packed_variant_buffer<T...>;
+    friend class packed_variant_iterator<!C, T...>;
+
+    using index_type = variant2::detail::smallest_unsigned_type<sizeof...(T)>;
+    using byte_type = mp_if_c<C, unsigned char const, unsigned char>;
+
+    byte_type * p_;
+
+    explicit packed_variant_iterator( byte_type * p ) noexcept: p_( p )
+    {
+    }
+
+public:
+
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = variant<T...>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = packed_variant_reference<C, T...>;
+
+    packed_variant_iterator() noexcept: p_( 0 )
+    {
+    }
+
+    template<bool C2, class E = std::enable_if_t<C && !C2>> packed_variant_iterator( packed_variant_iterator<C2, T...> const& r ) noexcept: p_( r.p_ )
+    {
+    }
+
+    reference operator*() const noexcept
+    {
+        return reference( p_ );
+    }
+
+    packed_variant_iterator& operator++() noexcept
+    {
+        std::size_t a = variant2::detail::packed_address( p_ );
+
+        p_ += variant2::detail::dispatch_index<sizeof...(T)>( reference( p_ ).index(), [&]( auto I ){
+
+            return variant2::detail::packed_next<index_type, mp_at_c<mp_list<T...>, I>>( a ) - a;
+
+        });
+
+        return *this;
+    }
+
+    packed_variant_iterator operator++( int ) noexcept
+    {
+        packed_variant_iterator r( *this );
+        ++*this;
+        return r;
+    }
+
+    friend bool operator==( packed_variant_iterator const& a, packed_variant_iterator const& b ) noexcept
+    {
+        return a.p_ == b.p_;
+    }
+
+    friend bool operator!=( packed_variant_iterator const& a, packed_variant_iterator const& b ) noexcept
+    {
+        return a.p_ != b.p_;
+    }
+};
+
+// packed_variant_buffer
+//
+// An append-only sequence of variant<T...> values, each stored in a single
+// byte buffer as its index followed by the held alternative, taking only
+// the space the alternative needs
+
+template<class... T> class packed_variant_buffer
+{
+private:
+
+    static_assert( sizeof...(T) > 0, "packed_variant_buffer requires at least one alternative" );
+    static_assert( mp_all<std::is_same<T, std::remove_cv_t<std::remove_reference_t<T>>>...>::value, "The alternatives of packed_variant_buffer must be non-const object types" );
+    static_assert( mp_all<mp_bool<( alignof( T ) <= alignof( std::max_align_t ) )>...>::value, "The alternatives of packed_variant_buffer must not be over-aligned" );
+
+    using index_type = variant2::detail::smallest_unsigned_type<sizeof...(T)>;
+
+    unsigned char * p_ = 0;
+
+    std::size_t n_ = 0; // bytes in use
+    std::size_t c_ = 0; // capacity, in bytes
+    std::size_t size_ = 0; // number of elements
+
+    // walks the elements of p, calling f( I, o ) with the index and the
+    // offset of each
+
+    template<class F> static void _for_each( unsigned char const * p, std::size_t n, F f )
+    {
+        for( std::size_t o = 0; o < n; )
+        {
+            index_type ix;
+            std::memcpy( &ix, p + o, sizeof( ix ) );
+
+            o = variant2::detail::dispatch_index<sizeof...(T)>( ix, [&]( auto I ){
+
+                f( I, o );
+                return variant2::detail::packed_next<index_type, mp_at_c<mp_list<T...>, I>>( o );
+
+            });
+        }
+    }
+
+    static void _destroy( unsigned char * p, std::size_t n ) noexcept
+    {
+        _destroy( p, n, mp_all<std::is_trivially_destructible<T>...>() );
+    }
+
+    static void _destroy( unsigned char *, std::size_t, mp_true ) noexcept
+    {
+    }
+
+    static void _destroy( unsigned char * p, std::size_t n, mp_false ) noexcept
+    {
+        _for_each( p, n, [&]( auto I, std::size_t o ){
+
+            using U = mp_at_c<mp_list<T...>, I>;
+            static_cast<U*>( static_cast<void*>( p + variant2::detail::packed_payload<index_type, U>( o ) ) )->~U();
+
+        });
+    }
+
+    // constructs in d the n bytes of elements of s; moving them when the tag
+    // is mp_true and their move constructor doesn't throw, copying otherwise
+
+    template<class M> static void _construct_from( unsigned char * d, unsigned char * s, std::size_t n, M )
+    {
+        if( n ) std::memcpy( d, s, n );
+
+        std::size_t e = 0; // end of the constructed elements
+
+        try
+        {
+            _for_each( s, n, [&]( auto I, std::size_t o ){
+
+                using U = mp_at_c<mp_list<T...>, I>;
+
+                std::size_t const k = variant2::detail::packed_payload<index_type, U>( o );
+                U & u = *static_cast<U*>( static_cast<void*>( s + k ) );
+
+                _construct( d + k, u, M() );
+                e = variant2::detail::packed_next<index_type, U>( o );
+
+            });
+        }
+        catch( ... )
+        {
+            _destroy( d, e );
+            throw;
+        }
+    }
+
+    template<class U> static void _construct( unsigned char * d, U & u, mp_true )
+    {
+        ::new( d ) U( std::move_if_noexcept( u ) );
+    }
+
+    template<class U> static void _construct( unsigned char * d, U & u, mp_false )
+    {
+        ::new( d ) U( static_cast<U const&>( u ) );
+    }
+
+    static unsigned char * _allocate( std::size_t c )
+    {
+        return static_cast<unsigned char*>( ::operator new( c ) );
+    }
+
+    std::size_t _grown_capacity( std::size_t m ) const noexcept
+    {
+        std::size_t c = c_? c_: 256;
+        while( c < m ) c *= 2;
+
+        return c;
+    }
+
+    void _grow( std::size_t m )
+    {
+        std::size_t const c = _grown_capacity( m );
+        unsigned char * p = _allocate( c );
+
+        try
+        {
+            _relocate_to( p, mp_all<is_trivially_relocatable<T>...>() );
+        }
+        catch( ... )
+        {
+            ::operator delete( p );
+            throw;
+        }
+
+        _replace_block( p, c );
+    }
+
+    // constructs a U at offset k of a new block holding at least m bytes,
+    // then moves the elements there; in this order, because a may refer
+    // to one of them
+
+    template<class U, class... A> void _grow_emplace( std::size_t k, std::size_t m, A&&... a )
+    {
+        std::size_t const c = _grown_capacity( m );
+        unsigned char * p = _allocate( c );
+
+        try
+        {
+            ::new( p + k ) U( std::forward<A>(a)... );
+        }
+        catch( ... )
+        {
+            ::operator delete( p );
+            throw;
+        }
+
+        try
+        {
+            _relocate_to( p, mp_all<is_trivially_relocatable<T>...>() );
+        }
+        catch( ... )
+        {
+            static_cast<U*>( static_cast<void*>( p + k ) )->~U();
+            ::operator delete( p );
+            throw;
+        }
+
+        _replace_block( p, c );
+    }
+
+    // moves the elements into p, which doesn't own them yet
+
+    void _relocate_to( unsigned char * p, mp_true ) noexcept
+    {
+        if( n_ ) std::memcpy( p, p_, n_ );
+    }
+
+    void _relocate_to( unsigned char * p, mp_false )
+    {
+        _construct_from( p, p_, n_, mp_true() );
+        _destroy( p_, n_ );
+    }
+
+    void _replace_block( unsigned char * p, std::size_t c ) noexcept
+    {
+        ::operator delete( p_ );
+
+        p_ = p;
+        c_ = c;
+    }
+
+public:
+
+    using value_type = variant<T...>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using reference = packed_variant_reference<false, T...>;
+    using const_reference = packed_variant_reference<true, T...>;
+
+    using iterator = packed_variant_iterator<false, T...>;
+    using const_iterator = packed_variant_iterator<true, T...>;
+
+    // constructors
+
+    packed_variant_buffer() = default;
+
+    packed_variant_buffer( packed_variant_buffer const& r ): packed_variant_buffer()
+    {
+        if( r.n_ == 0 ) return;
+
+        unsigned char * p = _allocate( r.n_ );
+
+        try
+        {
+            _construct_from( p, r.p_, r.n_, mp_false() );
+        }
+        catch( ... )
+        {
+            ::operator delete( p );
+            throw;
+        }
+
+        p_ = p;
+        n_ = c_ = r.n_;
+        size_ = r.size_;
+    }
+
+    packed_variant_buffer( packed_variant_buffer&& r ) noexcept: p_( r.p_ ), n_( r.n_ ), c_( r.c_ ), size_( r.size_ )
+    {
+        r.p_ = 0;
+        r.n_ = r.c_ = r.size_ = 0;
+    }
+
+    ~packed_variant_buffer() noexcept
+    {
+        _destroy( p_, n_ );
+        ::operator delete( p_ );
+    }
+
+    // assignment
+
+    packed_variant_buffer& operator=( packed_variant_buffer const& r )
+    {
+        packed_variant_buffer( r ).swap( *this );
+        return *this;
+    }
+
+    packed_variant_buffer& operator=( packed_variant_buffer&& r ) noexcept
+    {
+        packed_variant_buffer( std::move( r ) ).swap( *this );
+        return *this;
+    }
+
+    // capacity
+
+    bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    std::size_t size_bytes() const noexcept
+    {
+        return n_;
+    }
+
+    std::size_t capacity_bytes() const noexcept
+    {
+        return c_;
+    }
+
+    void reserve_bytes( std::size_t n )
+    {
+        if( n > c_ ) _grow( n );
+    }
+
+    // iterators
+
+    iterator begin() noexcept
+    {
+        return iterator( p_ );
+    }
+
+    iterator end() noexcept
+    {
+        return iterator( p_ + n_ );
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator( p_ );
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator( p_ + n_ );
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    // modifiers
+
+    template<std::size_t I, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<mp_list<T...>, I>, A&&...>::value>> reference emplace_back( A&&... a )
+    {
+        using U = mp_at_c<mp_list<T...>, I>;
+
+        std::size_t const k = variant2::detail::packed_payload<index_type, U>( n_ );
+        std::size_t const m = variant2::detail::packed_next<index_type, U>( n_ );
+
+        if( m > c_ )
+        {
+            _grow_emplace<U>( k, m, std::forward<A>(a)... );
+        }
+        else
+        {
+            ::new( p_ + k ) U( std::forward<A>(a)... );
+        }
+
+        index_type const ix = static_cast<index_type>( I );
+        std::memcpy( p_ + n_, &ix, sizeof( ix ) );
+
+        reference r( p_ + n_ );
+
+        n_ = m;
+        ++size_;
+
+        return r;
+    }
+
+    template<class U, class... A, class I = mp_find<mp_list<T...>, U>, class E = std::enable_if_t<I::value != sizeof...(T) && std::is_constructible<U, A&&...>::value>> reference emplace_back( A&&... a )
+    {
+        return emplace_back<I::value>( std::forward<A>(a)... );
+    }
+
+    template<class U,
+        class E1 = std::enable_if_t<!std::is_same<std::decay_t<U>, variant<T...>>::value>,
+        class V = variant2::detail::resolve_overload_type<U&&, T...>,
+        class E2 = std::enable_if_t<std::is_constructible<V, U&&>::value>
+        >
+    reference push_back( U&& u )
+    {
+        return emplace_back<variant2::detail::resolve_overload_index<U&&, T...>::value>( std::forward<U>(u) );
+    }
+
+    reference push_back( variant<T...> const& v )
+    {
+        return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+            return this->template emplace_back<I>( get<I>( v ) );
+
+        });
+    }
+
+    reference push_back( variant<T...>&& v )
+    {
+        return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+            return this->template emplace_back<I>( get<I>( std::move( v ) ) );
+
+        });
+    }
+
+    void clear() noexcept
+    {
+        _destroy( p_, n_ );
+
+        n_ = 0;
+        size_ = 0;
+    }
+
+    void swap( packed_variant_buffer& r ) noexcept
+    {
+        std::swap( p_, r.p_ );
+        std::swap( n_, r.n_ );
+        std::swap( c_, r.c_ );
+        std::swap( size_, r.size_ );
+    }
+};
+
+// holds_alternative
+
+template<class U, bool C, class... T> bool holds_alternative( packed_variant_reference<C, T...> const& r ) noexcept
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    return r.index() == mp_find<mp_list<T...>, U>::value;
+}
+
+// get (index)
+//
+// packed_variant_reference refers to the element, so get returns an
+// lvalue for it regardless of the value category of the reference
+
+template<std::size_t I, bool C, class... T> variant_alternative_t<I, packed_variant_reference<C, T...>> & get( packed_variant_reference<C, T...> const& r )
+{
+    static_assert( I < sizeof...(T), "Index out of bounds" );
+
+    if( r.index() != I ) throw bad_variant_access();
+    return r._get_impl( mp_size_t<I>() );
+}
+
+// get (type)
+
+template<class U, bool C, class... T> variant_alternative_t<mp_find<mp_list<T...>, U>::value, packed_variant_reference<C, T...>> & get( packed_variant_reference<C, T...> const& r )
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    constexpr auto I = mp_find<mp_list<T...>, U>::value;
+
+    if( r.index() != I ) throw bad_variant_access();
+    return r._get_impl( mp_size_t<I>() );
+}
+
+// get_if
+
+template<std::size_t I, bool C, class... T> variant_alternative_t<I, packed_variant_reference<C, T...>> * get_if( packed_variant_reference<C, T...> const * r ) noexcept
+{
+    static_assert( I < sizeof...(T), "Index out of bounds" );
+    return r && r->index() == I? &r->_get_impl( mp_size_t<I>() ): 0;
+}
+
+template<class U, bool C, class... T> variant_alternative_t<mp_find<mp_list<T...>, U>::value, packed_variant_reference<C, T...>> * get_if( packed_variant_reference<C, T...> const * r ) noexcept
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    constexpr auto I = mp_find<mp_list<T...>, U>::value;
+
+    return r && r->index() == I? &r->_get_impl( mp_size_t<I>() ): 0;
+}
+
+// visitation
+//
+// visit() works with packed_variant_reference through variant_size,
+// variant_alternative and get
+
+// specialized algorithms
+
+template<class... T> void swap( packed_variant_buffer<T...> & v, packed_variant_buffer<T...> & w ) noexcept
+{
+    v.swap( w );
+}
+
+} // namespace variant2
+} // namespace boost
+
+#endif // #ifndef BOOST_VARIANT2_PACKED_VARIANT_BUFFER_HPP_INCLUDED
@@ -0,0 +1,289 @@
+#ifndef BOOST_VARIANT2_PTR_VARIANT_HPP_INCLUDED
+#define BOOST_VARIANT2_PTR_VARIANT_HPP_INCLUDED
+
+//  Copyright 2017 Peter Dimov.
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#ifndef BOOST_VARIANT2_VARIANT_HPP_INCLUDED
+#include <boost/variant2/variant.hpp>
+#endif
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <cassert>
+#include <utility>
+
+//
+
+namespace boost
+{
+namespace variant2
+{
+
+// ptr_variant forward declaration
+
+template<class... T> class ptr_variant;
+
+// variant_size
+
+template<class... T> struct variant_size<ptr_variant<T...>>: mp_size<ptr_variant<T...>>
+{
+};
+
+// variant_alternative
+
+template<std::size_t I, class... T> struct variant_alternative<I, ptr_variant<T...>>: mp_defer<mp_at, ptr_variant<T...>, mp_size_t<I>>
+{
+};
+
+namespace detail
+{
+
+// ptr_variant_alignment
+//
+// The low bits of a T* that are always zero, and are therefore available
+// to hold the index, are those below alignof(*T)
+
+template<class T> using is_object_pointer = mp_bool<std::is_pointer<T>::value && std::is_object<std::remove_pointer_t<T>>::value>;
+
+template<class T> using ptr_variant_alignment = mp_size_t<alignof( std::remove_pointer_t<T> )>;
+
+template<class... T> using ptr_variant_min_alignment = mp_min_element<mp_list<ptr_variant_alignment<T>...>, mp_less>;
+
+template<class... T> using ptr_variant_has_index_bits = mp_bool<sizeof...(T) <= ptr_variant_min_alignment<T...>::value>;
+
+} // namespace detail
+
+// ptr_variant
+
+template<class... T> class ptr_variant
+{
+private:
+
+    static_assert( sizeof...(T) > 0, "ptr_variant requires at least one alternative" );
+    static_assert( mp_all<variant2::detail::is_object_pointer<T>...>::value, "The alternatives of ptr_variant must be pointers to object types" );
+
+    std::uintptr_t p_;
+
+    // the pointed-to types can still be incomplete when ptr_variant is
+    // instantiated, as in a node type holding ptr_variants of nodes, so
+    // their alignment is only taken in the member functions
+
+    static constexpr std::uintptr_t _mask() noexcept
+    {
+        static_assert( variant2::detail::ptr_variant_has_index_bits<T...>::value, "The alignment of the pointed-to types leaves too few low bits to hold the index" );
+
+        return variant2::detail::ptr_variant_min_alignment<T...>::value - 1;
+    }
+
+    template<std::size_t I> static std::uintptr_t _encode( mp_at_c<ptr_variant<T...>, I> p ) noexcept
+    {
+        std::uintptr_t const q = reinterpret_cast<std::uintptr_t>( p );
+
+        assert( ( q & _mask() ) == 0 );
+
+        return q | I;
+    }
+
+public:
+
+    // constructors
+
+    constexpr ptr_variant() noexcept: p_( 0 )
+    {
+        static_assert( variant2::detail::ptr_variant_has_index_bits<T...>::value, "The alignment of the pointed-to types leaves too few low bits to hold the index" );
+    }
+
+    template<class U,
+        class Ud = std::decay_t<U>,
+        class E1 = std::enable_if_t< !std::is_same<Ud, ptr_variant>::value && !variant2::detail::is_in_place_index<Ud>::value && !variant2::detail::is_in_place_type<Ud>::value >,
+        class V = variant2::detail::resolve_overload_type<U&&, T...>,
+        class E2 = std::enable_if_t<std::is_constructible<V, U>::value>
+        >
+    ptr_variant( U&& u ) noexcept
+        : p_( _encode<variant2::detail::resolve_overload_index<U&&, T...>::value>( std::forward<U>(u) ) )
+    {
+    }
+
+    template<class U, class I = mp_find<ptr_variant<T...>, U>, class E = std::enable_if_t<I::value != sizeof...(T)>>
+    explicit ptr_variant( in_place_type_t<U>, U p = nullptr ) noexcept: p_( _encode<I::value>( p ) )
+    {
+    }
+
+    template<std::size_t I, class E = std::enable_if_t<I < sizeof...(T)>>
+    explicit ptr_variant( in_place_index_t<I>, mp_at_c<ptr_variant<T...>, I> p = nullptr ) noexcept: p_( _encode<I>( p ) )
+    {
+    }
+
+    // assignment
+
+    template<class U,
+        class E1 = std::enable_if_t<!std::is_same<std::decay_t<U>, ptr_variant>::value>,
+        class V = variant2::detail::resolve_overload_type<U, T...>,
+        class E2 = std::enable_if_t<std::is_assignable<V&, U>::value && std::is_constructible<V, U>::value>
+    >
+    ptr_variant& operator=( U&& u ) noexcept
+    {
+        p_ = _encode<variant2::detail::resolve_overload_index<U, T...>::value>( std::forward<U>(u) );
+        return *this;
+    }
+
+    // modifiers
+
+    template<class U, class I = mp_find<ptr_variant<T...>, U>, class E = std::enable_if_t<I::value != sizeof...(T)>>
+    U emplace( U p = nullptr ) noexcept
+    {
+        p_ = _encode<I::value>( p );
+        return p;
+    }
+
+    template<std::size_t I, class E = std::enable_if_t<I < sizeof...(T)>>
+    mp_at_c<ptr_variant<T...>, I> emplace( mp_at_c<ptr_variant<T...>, I> p = nullptr ) noexcept
+    {
+        p_ = _encode<I>( p );
+        return p;
+    }
+
+    // value status
+
+    constexpr std::size_t index() const noexcept
+    {
+        return p_ & _mask();
+    }
+
+    // swap
+
+    void swap( ptr_variant& r ) noexcept
+    {
+        std::swap( p_, r.p_ );
+    }
+
+    // private accessors
+
+    constexpr std::uintptr_t _real_index() const noexcept
+    {
+        return p_;
+    }
+
+    template<std::size_t I> mp_at_c<ptr_variant<T...>, I> _get_impl( mp_size_t<I> ) const noexcept
+    {
+        assert( index() == I );
+        return reinterpret_cast<mp_at_c<ptr_variant<T...>, I>>( p_ & ~_mask() );
+    }
+};
+
+// holds_alternative
+
+template<class U, class... T> constexpr bool holds_alternative( ptr_variant<T...> const& v ) noexcept
+{
+    static_assert( mp_count<ptr_variant<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    return v.index() == mp_find<ptr_variant<T...>, U>::value;
+}
+
+// get (index)
+//
+// The pointers are not stored as such, so get returns them by value
+
+template<std::size_t I, class... T> variant_alternative_t<I, ptr_variant<T...>> get( ptr_variant<T...> const& v )
+{
+    static_assert( I < sizeof...(T), "Index out of bounds" );
+
+    if( v.index() != I ) throw bad_variant_access();
+    return v._get_impl( mp_size_t<I>() );
+}
+
+// get (type)
+
+template<class U, class... T> U get( ptr_variant<T...> const& v )
+{
+    static_assert( mp_count<ptr_variant<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    constexpr auto I = mp_find<ptr_variant<T...>, U>::value;
+
+    if( v.index() != I ) throw bad_variant_access();
+    return v._get_impl( mp_size_t<I>() );
+}
+
+// get_if
+//
+// Returns an alternative_value holding the pointer held by *v when it's of
+// the requested alternative, and an empty one otherwise, so that a held
+// nullptr can be told apart from another alternative
+
+template<std::size_t I, class... T> alternative_value<variant_alternative_t<I, ptr_variant<T...>>> get_if( ptr_variant<T...> const * v ) noexcept
+{
+    static_assert( I < sizeof...(T), "Index out of bounds" );
+    using R = alternative_value<variant_alternative_t<I, ptr_variant<T...>>>;
+
+    return v && v->index() == I? R( v->_get_impl( mp_size_t<I>() ) ): R();
+}
+
+template<class U, class... T> alternative_value<U> get_if( ptr_variant<T...> const * v ) noexcept
+{
+    static_assert( mp_count<ptr_variant<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    constexpr auto I = mp_find<ptr_variant<T...>, U>::value;
+
+    return v && v->index() == I? alternative_value<U>( v->_get_impl( mp_size_t<I>() ) ): alternative_value<U>();
+}
+
+// relational operators
+
+template<class... T> constexpr bool operator==( ptr_variant<T...> const & v, ptr_variant<T...> const & w )
+{
+    return v._real_index() == w._real_index();
+}
+
+template<class... T> constexpr bool operator!=( ptr_variant<T...> const & v, ptr_variant<T...> const & w )
+{
+    return v._real_index() != w._real_index();
+}
+
+template<class... T> bool operator<( ptr_variant<T...> const & v, ptr_variant<T...> const & w )
+{
+    if( v.index() < w.index() ) return true;
+    if( v.index() > w.index() ) return false;
+
+    return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+        // unrelated pointers are ordered only by std::less
+
+        return std::less<>()( v._get_impl( I ), w._get_impl( I ) );
+
+    });
+}
+
+template<class... T> bool operator>( ptr_variant<T...> const & v, ptr_variant<T...> const & w )
+{
+    return w < v;
+}
+
+template<class... T> bool operator<=( ptr_variant<T...> const & v, ptr_variant<T...> const & w )
+{
+    return !( w < v );
+}
+
+template<class... T> bool operator>=( ptr_variant<T...> const & v, ptr_variant<T...> const & w )
+{
+    return !( v < w );
+}
+
+// visitation
+//
+// visit() works with ptr_variant through variant_size, variant_alternative
+// and get, with the alternatives passed by value
+
+// specialized algorithms
+
+template<class... T> void swap( ptr_variant<T...> & v, ptr_variant<T...> & w ) noexcept
+{
+    v.swap( w );
+}
+
+} // namespace variant2
+} // namespace boost
+
+#endif // #ifndef BOOST_VARIANT2_PTR_VARIANT_HPP_INCLUDED
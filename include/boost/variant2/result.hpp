@@ -68,6 +68,8 @@ private:
 
     variant<T, std::error_code> v_;
 
+    template<class T2> friend std::size_t hash_value( result<T2> const & x );
+
 public:
 
     // constructors
@@ -88,6 +90,13 @@ public:
     {
     }
 
+    // constructs the value from the result of f(); since C++17, it isn't moved
+
+    template<class F, class E = std::enable_if_t<variant2::detail::is_factory_constructible<T, variant2::detail::factory_result<F>>::value>>
+    constexpr result( in_place_factory_t, F&& f ): v_( in_place_factory, [&]() -> T { return std::forward<F>(f)(); } )
+    {
+    }
+
     // queries
 
     constexpr bool has_value() const noexcept
@@ -199,17 +208,27 @@ public:
 
     void set_value( T const& t ) noexcept( std::is_nothrow_copy_constructible<T>::value )
     {
-        v_.emplace<0>( t );
+        v_.template emplace<0>( t );
     }
 
     void set_value( T&& t ) noexcept( std::is_nothrow_move_constructible<T>::value )
     {
-        v_.emplace<0>( std::move( t ) );
+        v_.template emplace<0>( std::move( t ) );
     }
 
     void set_error( std::error_code const & e ) noexcept
     {
-        v_.emplace<1>( e );
+        v_.template emplace<1>( e );
+    }
+
+    // sets the value from the result of f(); since C++17, a prvalue T is
+    // constructed in place, unless a temporary is needed to keep the old
+    // state if f throws
+
+    template<class F, class E = std::enable_if_t<variant2::detail::is_factory_constructible<T, variant2::detail::factory_result<F>>::value>>
+    T& emplace_with( F&& f )
+    {
+        return v_.template emplace_with<0>( std::forward<F>(f) );
     }
 
     // swap
@@ -220,7 +239,23 @@ public:
     }
 };
 
+template<class T> std::size_t hash_value( result<T> const & x )
+{
+    return hash_value( x.v_ );
+}
+
 } // namespace variant2
 } // namespace boost
 
+// std::hash
+
+namespace std
+{
+
+template<class T> struct hash<::boost::variant2::result<T>>: ::boost::variant2::detail::hash_base<::boost::variant2::result<T>, ::boost::variant2::detail::is_hash_enabled<T>>
+{
+};
+
+} // namespace std
+
 #endif // #ifndef BOOST_VARIANT2_RESULT_HPP_INCLUDED
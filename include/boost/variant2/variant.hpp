@@ -14,12 +14,62 @@
 #include <boost/config.hpp>
 #include <boost/detail/workaround.hpp>
 #include <cstddef>
+#include <cstdint>
 #include <type_traits>
 #include <exception>
 #include <cassert>
+#include <climits>
+#include <cstring>
+#include <functional>
 #include <initializer_list>
 #include <utility>
 
+// BOOST_VARIANT2_IS_CONSTANT_EVALUATED
+
+#if !defined( BOOST_VARIANT2_IS_CONSTANT_EVALUATED )
+
+#if defined( __has_builtin )
+#if __has_builtin( __builtin_is_constant_evaluated )
+#define BOOST_VARIANT2_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#elif BOOST_WORKAROUND( BOOST_GCC, >= 90000 ) || BOOST_WORKAROUND( BOOST_MSVC, >= 1925 )
+#define BOOST_VARIANT2_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+
+#endif
+
+// BOOST_VARIANT2_COLD
+
+#if !defined( BOOST_VARIANT2_COLD )
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define BOOST_VARIANT2_COLD __attribute__(( __cold__ ))
+#else
+#define BOOST_VARIANT2_COLD
+#endif
+
+#endif
+
+// BOOST_VARIANT2_HAS_THREE_WAY_COMPARISON
+
+#if defined( __cpp_impl_three_way_comparison ) && __cpp_impl_three_way_comparison >= 201907L && defined( __has_include )
+#if __has_include( <compare> )
+#include <compare>
+#if defined( __cpp_lib_three_way_comparison ) && __cpp_lib_three_way_comparison >= 201907L
+#define BOOST_VARIANT2_HAS_THREE_WAY_COMPARISON
+#endif
+#endif
+#endif
+
+// BOOST_VARIANT2_MAX_FLAT_VISIT
+//
+// The largest product of the alternative counts for which visit(f, v1, v2, ...)
+// dispatches once on the combined index instead of once per variant
+
+#if !defined( BOOST_VARIANT2_MAX_FLAT_VISIT )
+#define BOOST_VARIANT2_MAX_FLAT_VISIT 256
+#endif
+
 //
 
 namespace boost
@@ -75,6 +125,27 @@ constexpr bool operator!=(valueless, valueless) noexcept { return false; }
 
 template<class... T> class variant;
 
+// basic_variant forward declaration (extension)
+
+namespace variant_policy
+{
+
+struct never_valueless
+{
+};
+
+struct may_be_valueless
+{
+};
+
+} // namespace variant_policy
+
+template<class P, class... T> class basic_variant;
+
+// variant_npos
+
+constexpr std::size_t variant_npos = ~static_cast<std::size_t>( 0 );
+
 // variant_size
 
 template<class T> struct variant_size
@@ -304,11 +375,271 @@ template<class U, class... T> constexpr std::add_pointer_t<U const> get_if(varia
     return v && v->index() == I? &v->_get_impl( mp_size_t<I>() ): 0;
 }
 
+// niche_traits (extension)
+//
+// A specialization for T declares spare_count values of T that a variant
+// never needs to store as a T, and which it can therefore use to encode
+// which one of its other, empty, alternatives is active:
+//
+//     static constexpr std::size_t spare_count = N;
+//     static constexpr T spare( std::size_t i ) noexcept; // 0 <= i < N
+//     static constexpr std::size_t spare_index( T const& t ) noexcept; // i if t == spare(i), N otherwise
+
+template<class T> struct niche_traits
+{
+    static constexpr std::size_t spare_count = 0;
+};
+
+// use_heap_backup (extension)
+//
+// A variant V that would otherwise need double storage uses a single one,
+// and backs the current value up on the heap during a potentially throwing
+// emplace, when use_heap_backup<V>::value is true. The default is given by
+// BOOST_VARIANT2_USE_HEAP_BACKUP.
+
+#if defined( BOOST_VARIANT2_USE_HEAP_BACKUP )
+
+template<class V> struct use_heap_backup: std::true_type
+{
+};
+
+#else
+
+template<class V> struct use_heap_backup: std::false_type
+{
+};
+
+#endif
+
+// is_trivially_relocatable (extension)
+//
+// A type is trivially relocatable when moving an object to a new address
+// and destroying the original can be done by copying its bytes. This holds
+// for trivially copyable types, and a specialization can declare it for
+// others; variant<T...> and basic_variant<P, T...> are trivially
+// relocatable when all T are.
+
+template<class T> struct is_trivially_relocatable: mp_bool<std::is_trivially_copyable<T>::value>
+{
+};
+
+template<class T> struct is_trivially_relocatable<T const>: is_trivially_relocatable<T>
+{
+};
+
+template<class... T> struct is_trivially_relocatable<variant<T...>>: mp_all<is_trivially_relocatable<T>...>
+{
+};
+
+template<class P, class... T> struct is_trivially_relocatable<basic_variant<P, T...>>: mp_all<is_trivially_relocatable<T>...>
+{
+};
+
+// is_cold_alternative (extension)
+//
+// Specialized to derive from std::true_type for alternatives that are rarely
+// held. The operations that dispatch on the index handle them in out of line,
+// cold functions, which keeps them out of the inlined code at call sites.
+
+template<class T> struct is_cold_alternative: std::false_type
+{
+};
+
+// is_bitwise_comparable (extension)
+//
+// Specialized to derive from std::true_type for types without padding whose
+// operator== compares their bytes; equality of variants whose alternatives
+// are all bitwise comparable compares the index and the bytes of the held
+// alternative, without a dispatch.
+
+template<class T> struct is_bitwise_comparable: mp_bool<std::is_integral<T>::value || std::is_enum<T>::value>
+{
+};
+
+template<class T> struct is_bitwise_comparable<T const>: is_bitwise_comparable<T>
+{
+};
+
+// dispatch (extension)
+//
+// Policies for turning a run time index into a compile time one, used by
+// visit<D>() and, through dispatch::default_dispatch, by visit() and the
+// internal dispatchers:
+//
+//     dense_switch   mp_with_index, a switch for small N, recursive for larger
+//     jump_table     an array of function pointers, indexed
+//     binary_search  a balanced tree of comparisons
+//     if_chain       a sequence of comparisons, in index order
+//
+// default_dispatch is dense_switch, unless BOOST_VARIANT2_DEFAULT_DISPATCH
+// is defined to one of the others.
+
+namespace dispatch
+{
+
+struct dense_switch
+{
+};
+
+struct jump_table
+{
+};
+
+struct binary_search
+{
+};
+
+struct if_chain
+{
+};
+
+#if defined( BOOST_VARIANT2_DEFAULT_DISPATCH )
+
+using default_dispatch = BOOST_VARIANT2_DEFAULT_DISPATCH;
+
+#else
+
+using default_dispatch = dense_switch;
+
+#endif
+
+template<class D> struct is_dispatch: mp_contains<mp_list<dense_switch, jump_table, binary_search, if_chain>, D>
+{
+};
+
+} // namespace dispatch
+
 //
 
 namespace detail
 {
 
+// dispatch_index
+
+template<class F> using dispatch_result = decltype( std::declval<F>()( std::declval<mp_size_t<0>>() ) );
+
+template<class R, class F, std::size_t I> constexpr R dispatch_thunk( F&& f )
+{
+    return std::forward<F>(f)( mp_size_t<I>() );
+}
+
+template<class R, class F, class L> struct dispatch_jump_table;
+
+template<class R, class F, std::size_t... I> struct dispatch_jump_table<R, F, std::index_sequence<I...>>
+{
+    static constexpr R (*table[ sizeof...(I) ])( F&& ) = { &dispatch_thunk<R, F, I>... };
+};
+
+template<class R, class F, std::size_t... I> constexpr R (*dispatch_jump_table<R, F, std::index_sequence<I...>>::table[ sizeof...(I) ])( F&& );
+
+template<std::size_t L, std::size_t H, bool B = ( H - L == 1 )> struct dispatch_binary_search
+{
+    template<class F> static constexpr dispatch_result<F> call( std::size_t i, F&& f )
+    {
+        return i < L + ( H - L ) / 2?
+            dispatch_binary_search<L, L + ( H - L ) / 2>::call( i, std::forward<F>(f) ):
+            dispatch_binary_search<L + ( H - L ) / 2, H>::call( i, std::forward<F>(f) );
+    }
+};
+
+template<std::size_t L, std::size_t H> struct dispatch_binary_search<L, H, true>
+{
+    template<class F> static constexpr dispatch_result<F> call( std::size_t /*i*/, F&& f )
+    {
+        return std::forward<F>(f)( mp_size_t<L>() );
+    }
+};
+
+template<std::size_t K, std::size_t N, bool B = ( K + 1 == N )> struct dispatch_if_chain
+{
+    template<class F> static constexpr dispatch_result<F> call( std::size_t i, F&& f )
+    {
+        return i == K? std::forward<F>(f)( mp_size_t<K>() ): dispatch_if_chain<K + 1, N>::call( i, std::forward<F>(f) );
+    }
+};
+
+template<std::size_t K, std::size_t N> struct dispatch_if_chain<K, N, true>
+{
+    template<class F> static constexpr dispatch_result<F> call( std::size_t /*i*/, F&& f )
+    {
+        return std::forward<F>(f)( mp_size_t<K>() );
+    }
+};
+
+template<std::size_t N, class F> constexpr dispatch_result<F> dispatch_index_impl( dispatch::dense_switch, std::size_t i, F&& f )
+{
+    return mp_with_index<N>( i, std::forward<F>(f) );
+}
+
+template<std::size_t N, class F> constexpr dispatch_result<F> dispatch_index_impl( dispatch::jump_table, std::size_t i, F&& f )
+{
+    return assert( i < N ), dispatch_jump_table<dispatch_result<F>, F, std::make_index_sequence<N>>::table[ i ]( std::forward<F>(f) );
+}
+
+template<std::size_t N, class F> constexpr dispatch_result<F> dispatch_index_impl( dispatch::binary_search, std::size_t i, F&& f )
+{
+    return assert( i < N ), dispatch_binary_search<0, N>::call( i, std::forward<F>(f) );
+}
+
+template<std::size_t N, class F> constexpr dispatch_result<F> dispatch_index_impl( dispatch::if_chain, std::size_t i, F&& f )
+{
+    return assert( i < N ), dispatch_if_chain<0, N>::call( i, std::forward<F>(f) );
+}
+
+// calls f( mp_size_t<i>() ), i < N, using the dispatch policy D
+
+template<std::size_t N, class D = dispatch::default_dispatch, class F> constexpr dispatch_result<F> dispatch_index( std::size_t i, F&& f )
+{
+    static_assert( dispatch::is_dispatch<D>::value, "D must be one of the dispatch policies" );
+    return dispatch_index_impl<N>( D(), i, std::forward<F>(f) );
+}
+
+// dispatch_index_cold
+//
+// dispatch_index, with the calls for the indices I for which mp_at<C, I> is
+// true made through an out of line, cold function
+
+template<class F, class I> BOOST_NOINLINE BOOST_VARIANT2_COLD constexpr auto cold_call( F& f, I i ) -> decltype( f( i ) )
+{
+    return f( i );
+}
+
+template<class C, class F> struct cold_caller
+{
+    F& f_;
+
+    template<class I> constexpr auto call( mp_false, I i ) const -> decltype( f_( i ) )
+    {
+        return f_( i );
+    }
+
+    template<class I> constexpr auto call( mp_true, I i ) const -> decltype( f_( i ) )
+    {
+        return cold_call( f_, i );
+    }
+
+    template<class I> constexpr auto operator()( I i ) const -> decltype( f_( i ) )
+    {
+        return call( mp_bool<mp_at<C, I>::value>(), i );
+    }
+};
+
+template<class C, class D = dispatch::default_dispatch, class F> constexpr dispatch_result<F&> dispatch_index_cold( std::size_t i, F&& f )
+{
+    return dispatch_index<mp_size<C>::value, D>( i, cold_caller<C, F>{ f } );
+}
+
+// dispatch_alternative
+//
+// dispatch_index over the alternatives L, respecting is_cold_alternative
+
+template<class T> using is_cold = mp_bool<is_cold_alternative<std::remove_cv_t<T>>::value>;
+
+template<class L, class D = dispatch::default_dispatch, class F> constexpr dispatch_result<F&> dispatch_alternative( std::size_t i, F&& f )
+{
+    return dispatch_index_cold<mp_transform<is_cold, L>, D>( i, f );
+}
+
 // trivially_*
 
 #if defined( BOOST_LIBSTDCXX_VERSION ) && BOOST_LIBSTDCXX_VERSION < 50000
@@ -338,6 +669,36 @@ using std::is_trivially_move_assignable;
 
 #endif
 
+// factory_arg
+//
+// Wraps a function object f for emplace_with and in_place_factory. The
+// storage constructs the alternative directly from the prvalue that f()
+// returns, so that since C++17 it's not moved; elsewhere, as when emplace
+// needs a temporary, it converts to the result of f()
+
+template<class F> struct factory_arg
+{
+    using result_type = decltype( std::declval<F>()() );
+
+    F&& f_;
+
+    constexpr result_type operator()() const noexcept( noexcept( std::declval<F>()() ) )
+    {
+        return std::forward<F>( f_ )();
+    }
+
+    constexpr operator result_type() const noexcept( noexcept( std::declval<F>()() ) )
+    {
+        return std::forward<F>( f_ )();
+    }
+};
+
+template<class F> using factory_result = decltype( std::declval<F>()() );
+
+// a prvalue of the type itself needs no constructor since C++17
+
+template<class U, class R> using is_factory_constructible = mp_bool<std::is_same<U, R>::value || std::is_constructible<U, R>::value>;
+
 // variant_storage
 
 template<class D, class... T> union variant_storage_impl;
@@ -358,6 +719,10 @@ template<class T1, class... T> union variant_storage_impl<mp_false, T1, T...>
     {
     }
 
+    template<class F> constexpr explicit variant_storage_impl( mp_size_t<0>, factory_arg<F> a ): first_( a() )
+    {
+    }
+
     template<std::size_t I, class... A> constexpr explicit variant_storage_impl( mp_size_t<I>, A&&... a ): rest_( mp_size_t<I-1>(), std::forward<A>(a)... )
     {
     }
@@ -371,6 +736,11 @@ template<class T1, class... T> union variant_storage_impl<mp_false, T1, T...>
         ::new( &first_ ) T1( std::forward<A>(a)... );
     }
 
+    template<class F> void emplace( mp_size_t<0>, factory_arg<F> a )
+    {
+        ::new( &first_ ) T1( a() );
+    }
+
     template<std::size_t I, class... A> void emplace( mp_size_t<I>, A&&... a )
     {
         rest_.emplace( mp_size_t<I-1>(), std::forward<A>(a)... );
@@ -393,6 +763,10 @@ template<class T1, class... T> union variant_storage_impl<mp_true, T1, T...>
     {
     }
 
+    template<class F> constexpr explicit variant_storage_impl( mp_size_t<0>, factory_arg<F> a ): first_( a() )
+    {
+    }
+
     template<std::size_t I, class... A> constexpr explicit variant_storage_impl( mp_size_t<I>, A&&... a ): rest_( mp_size_t<I-1>(), std::forward<A>(a)... )
     {
     }
@@ -402,13 +776,31 @@ template<class T1, class... T> union variant_storage_impl<mp_true, T1, T...>
         ::new( &first_ ) T1( std::forward<A>(a)... );
     }
 
+    template<class F> void emplace_impl( mp_false, mp_size_t<0>, factory_arg<F> a )
+    {
+        ::new( &first_ ) T1( a() );
+    }
+
     template<std::size_t I, class... A> constexpr void emplace_impl( mp_false, mp_size_t<I>, A&&... a )
     {
         rest_.emplace( mp_size_t<I-1>(), std::forward<A>(a)... );
     }
 
+    // assigning a new union works in constant expressions, but copies all
+    // of it; at run time, construct only the new alternative in place
+
     template<std::size_t I, class... A> constexpr void emplace_impl( mp_true, mp_size_t<I>, A&&... a )
     {
+#if defined( BOOST_VARIANT2_IS_CONSTANT_EVALUATED )
+
+        if( !BOOST_VARIANT2_IS_CONSTANT_EVALUATED() )
+        {
+            this->emplace_impl( mp_false(), mp_size_t<I>(), std::forward<A>(a)... );
+            return;
+        }
+
+#endif
+
         *this = variant_storage_impl( mp_size_t<I>(), std::forward<A>(a)... );
     }
 
@@ -461,61 +853,222 @@ template<class U, class... T> using resolve_overload_index = mp_find<mp_list<T..
 
 template<class... T> using can_be_valueless = std::is_same<mp_first<mp_list<T...>>, valueless>;
 
-template<bool is_trivially_destructible, bool is_single_buffered, class... T> struct variant_base_impl; // trivially destructible, single buffered
-template<class... T> using variant_base = variant_base_impl<mp_all<std::is_trivially_destructible<T>...>::value, mp_any<mp_all<std::is_nothrow_move_constructible<T>...>, can_be_valueless<T...>>::value, T...>;
+// index_type
+//
+// ix_ holds index() + 1 (0 means the `none` placeholder), so a single buffered
+// variant needs to represent [0, N]; a double buffered one also stores -J when
+// the second buffer is active and needs [-N, N]
 
-struct none {};
+template<std::size_t N> using smallest_unsigned_type = mp_cond<
 
-// trivially destructible, single buffered
-template<class... T> struct variant_base_impl<true, true, T...>
-{
-    int ix_;
-    variant_storage<none, T...> st1_;
+    mp_bool<N <= UCHAR_MAX>, unsigned char,
+    mp_bool<N <= USHRT_MAX>, unsigned short,
+    mp_true, unsigned
 
-    constexpr variant_base_impl(): ix_( 0 ), st1_( mp_size_t<0>() )
-    {
-    }
+>;
 
-    template<class I, class... A> constexpr explicit variant_base_impl( I, A&&... a ): ix_( I::value + 1 ), st1_( mp_size_t<I::value + 1>(), std::forward<A>(a)... )
-    {
-    }
+template<std::size_t N> using smallest_signed_type = mp_cond<
 
-    constexpr std::size_t index() const noexcept
-    {
-        return ix_ - 1;
-    }
+    mp_bool<N <= SCHAR_MAX>, signed char,
+    mp_bool<N <= SHRT_MAX>, short,
+    mp_true, int
 
-    template<std::size_t I> constexpr mp_at_c<variant<T...>, I>& _get_impl( mp_size_t<I> ) noexcept
-    {
-        size_t const J = I+1;
+>;
 
-        assert( ix_ == J );
+template<class... T> using is_single_buffered = mp_any<mp_all<std::is_nothrow_move_constructible<T>...>, can_be_valueless<T...>>;
 
-        return st1_.get( mp_size_t<J>() );
-    }
+template<bool is_trivially_destructible, bool is_single_buffered, class... T> struct variant_base_impl; // trivially destructible, single buffered
+template<class... T> struct variant_backup_base;
 
-    template<std::size_t I> constexpr mp_at_c<variant<T...>, I> const& _get_impl( mp_size_t<I> ) const noexcept
-    {
-        size_t const J = I+1;
+template<class... T> using variant_indexed_base = mp_if<mp_all<mp_not<is_single_buffered<T...>>, use_heap_backup<variant<T...>>>,
+    variant_backup_base<T...>,
+    variant_base_impl<mp_all<std::is_trivially_destructible<T>...>::value, is_single_buffered<T...>::value, T...>>;
 
-        assert( ix_ == J );
+// niche_*
+//
+// A variant whose alternatives are all empty, except for one, P, that has
+// enough spare values to number the rest, stores nothing but a P; the empty
+// alternatives are base class subobjects, and a spare value in the P encodes
+// which of them is active
 
-        return st1_.get( mp_size_t<J>() );
-    }
+template<class T> using is_niche_empty = mp_bool<std::is_empty<T>::value && !std::is_final<T>::value && std::is_trivially_default_constructible<T>::value && std::is_trivially_copyable<T>::value>;
 
-    template<std::size_t J, class U, bool B, class... A> constexpr void emplace_impl( mp_true, mp_bool<B>, A&&... a )
-    {
-        st1_.emplace( mp_size_t<J>(), std::forward<A>(a)... );
-        ix_ = J;
-    }
+template<class T> using is_niche_payload = mp_bool<std::is_trivially_copyable<T>::value && is_trivially_copy_constructible<T>::value && is_trivially_copy_assignable<T>::value>;
 
-    template<std::size_t J, class U, class... A> constexpr void emplace_impl( mp_false, mp_true, A&&... a )
-    {
-        U tmp( std::forward<A>(a)... );
+template<class... T> using niche_payload_index = mp_find_if<mp_list<T...>, mp_not_fn<is_niche_empty>::template fn>;
 
-        st1_.emplace( mp_size_t<J>(), std::move(tmp) );
-        ix_ = J;
-    }
+template<class... T> struct is_niche_variant_impl
+{
+    using P = mp_at_c<mp_list<T..., void>, niche_payload_index<T...>::value>;
+    using E = mp_remove_if<mp_list<T...>, mp_not_fn<is_niche_empty>::template fn>;
+
+    static constexpr bool value = sizeof...(T) >= 2 && mp_size<E>::value + 1 == sizeof...(T) && mp_is_set<E>::value && is_niche_payload<P>::value && niche_traits<P>::spare_count >= mp_size<E>::value;
+};
+
+template<class... T> using is_niche_variant = mp_bool<is_niche_variant_impl<T...>::value>;
+
+template<class... T> struct variant_niche_base;
+
+template<class... T> using variant_base = mp_if<is_niche_variant<T...>, variant_niche_base<T...>, variant_indexed_base<T...>>;
+
+template<class B> struct has_spare_buffer: mp_false
+{
+};
+
+template<bool D, class... T> struct has_spare_buffer<variant_base_impl<D, false, T...>>: mp_true
+{
+};
+
+struct none {};
+
+// variant_fields
+//
+// ix_ and the storage buffers; ix_ goes after the storage when the latter
+// is aligned more strictly than ix_ requires, since the bytes following it
+// are then tail padding that an enclosing object can reuse
+
+template<class I, class S> using index_after_storage = mp_bool<( alignof(S) > sizeof(I) )>;
+
+template<class I, class S, std::size_t N, bool L = index_after_storage<I, S>::value> struct variant_fields;
+
+template<class F> struct fields_index_after_storage;
+
+template<class I, class S, std::size_t N, bool L> struct fields_index_after_storage<variant_fields<I, S, N, L>>: mp_bool<L>
+{
+};
+
+template<class I, class S> struct variant_fields<I, S, 1, false>
+{
+    I ix_;
+    S st1_;
+
+    template<class J, class... A> constexpr explicit variant_fields( J, A&&... a ): ix_( J::value ), st1_( J(), std::forward<A>(a)... )
+    {
+    }
+};
+
+template<class I, class S> struct variant_fields<I, S, 1, true>
+{
+    S st1_;
+    I ix_;
+
+    template<class J, class... A> constexpr explicit variant_fields( J, A&&... a ): st1_( J(), std::forward<A>(a)... ), ix_( J::value )
+    {
+    }
+};
+
+template<class I, class S> struct variant_fields<I, S, 2, false>
+{
+    I ix_;
+    S st1_;
+    S st2_;
+
+    template<class J, class... A> constexpr explicit variant_fields( J, A&&... a ): ix_( J::value ), st1_( J(), std::forward<A>(a)... ), st2_( mp_size_t<0>() )
+    {
+    }
+};
+
+template<class I, class S> struct variant_fields<I, S, 2, true>
+{
+    S st1_;
+    S st2_;
+    I ix_;
+
+    template<class J, class... A> constexpr explicit variant_fields( J, A&&... a ): st1_( J(), std::forward<A>(a)... ), st2_( mp_size_t<0>() ), ix_( J::value )
+    {
+    }
+};
+
+// alternative_mask
+//
+// A bitmask with the bit J set when the J-th type of T satisfies P, so that
+// a single test on ix_ tells whether the alternative it holds is trivially
+// copied or destroyed, without a dispatch. Types past the 64th always
+// take the dispatch
+
+template<template<class> class P, class... T> constexpr std::uint64_t alternative_mask() noexcept
+{
+    bool const v[] = { false, P<T>::value... };
+
+    std::uint64_t m = 0;
+
+    for( std::size_t j = 0; j < sizeof...(T) && j < 64; ++j )
+    {
+        if( v[ j + 1 ] ) m |= std::uint64_t( 1 ) << j;
+    }
+
+    return m;
+}
+
+constexpr bool test_mask( std::uint64_t m, std::size_t j ) noexcept
+{
+    return j < 64 && ( ( m >> j ) & 1 ) != 0;
+}
+
+template<class T> using is_trivially_copyable_alternative = mp_bool<is_trivially_copy_constructible<T>::value && std::is_trivially_destructible<T>::value>;
+
+template<class T> using is_trivially_movable_alternative = mp_bool<is_trivially_move_constructible<T>::value && std::is_trivially_destructible<T>::value>;
+
+template<class... T> struct alternative_sizes
+{
+    static constexpr std::size_t value[] = { sizeof( T )... };
+};
+
+template<class... T> constexpr std::size_t alternative_sizes<T...>::value[];
+
+// trivially destructible, single buffered
+template<class... T> struct variant_base_impl<true, true, T...>: variant_fields<smallest_unsigned_type<sizeof...(T)>, variant_storage<none, T...>, 1>
+{
+    using index_type = smallest_unsigned_type<sizeof...(T)>;
+    using fields = variant_fields<index_type, variant_storage<none, T...>, 1>;
+
+    using fields::ix_;
+    using fields::st1_;
+
+    constexpr variant_base_impl(): fields( mp_size_t<0>() )
+    {
+    }
+
+    template<class I, class... A> constexpr explicit variant_base_impl( I, A&&... a ): fields( mp_size_t<I::value + 1>(), std::forward<A>(a)... )
+    {
+    }
+
+    constexpr std::size_t index() const noexcept
+    {
+        return ix_ - 1;
+    }
+
+    template<std::size_t I> constexpr mp_at_c<variant<T...>, I>& _get_impl( mp_size_t<I> ) noexcept
+    {
+        size_t const J = I+1;
+
+        assert( ix_ == J );
+
+        return st1_.get( mp_size_t<J>() );
+    }
+
+    template<std::size_t I> constexpr mp_at_c<variant<T...>, I> const& _get_impl( mp_size_t<I> ) const noexcept
+    {
+        size_t const J = I+1;
+
+        assert( ix_ == J );
+
+        return st1_.get( mp_size_t<J>() );
+    }
+
+    template<std::size_t J, class U, bool B, class... A> constexpr void emplace_impl( mp_true, mp_bool<B>, A&&... a )
+    {
+        st1_.emplace( mp_size_t<J>(), std::forward<A>(a)... );
+        ix_ = J;
+    }
+
+    template<std::size_t J, class U, class... A> constexpr void emplace_impl( mp_false, mp_true, A&&... a )
+    {
+        U tmp( std::forward<A>(a)... );
+
+        st1_.emplace( mp_size_t<J>(), std::move(tmp) );
+        ix_ = J;
+    }
 
     template<std::size_t J, class U, class... A> void emplace_impl( mp_false, mp_false, A&&... a )
     {
@@ -557,17 +1110,20 @@ template<class... T> struct variant_base_impl<true, true, T...>
 };
 
 // trivially destructible, double buffered
-template<class... T> struct variant_base_impl<true, false, T...>
+template<class... T> struct variant_base_impl<true, false, T...>: variant_fields<smallest_signed_type<sizeof...(T)>, variant_storage<none, T...>, 2>
 {
-    int ix_;
-    variant_storage<none, T...> st1_;
-    variant_storage<none, T...> st2_;
+    using index_type = smallest_signed_type<sizeof...(T)>;
+    using fields = variant_fields<index_type, variant_storage<none, T...>, 2>;
+
+    using fields::ix_;
+    using fields::st1_;
+    using fields::st2_;
 
-    constexpr variant_base_impl(): ix_( 0 ), st1_( mp_size_t<0>() ), st2_( mp_size_t<0>() )
+    constexpr variant_base_impl(): fields( mp_size_t<0>() )
     {
     }
 
-    template<class I, class... A> constexpr explicit variant_base_impl( I, A&&... a ): ix_( I::value + 1 ), st1_( mp_size_t<I::value + 1>(), std::forward<A>(a)... ), st2_( mp_size_t<0>() )
+    template<class I, class... A> constexpr explicit variant_base_impl( I, A&&... a ): fields( mp_size_t<I::value + 1>(), std::forward<A>(a)... )
     {
     }
 
@@ -596,14 +1152,20 @@ template<class... T> struct variant_base_impl<true, false, T...>
         return ix_ >= 0? st1_.get( j ): st2_.get( j );
     }
 
+    // constructs in the current buffer when that can't throw, so that the
+    // spare buffer stays cold; otherwise in the spare one, which is then
+    // made current
+
     template<std::size_t I, class... A> constexpr void emplace( A&&... a )
     {
         size_t const J = I+1;
 
-        if( ix_ >= 0 )
+        using U = mp_at_c<variant<T...>, I>;
+
+        if( std::is_nothrow_constructible<U, A...>::value? ix_ < 0: ix_ >= 0 )
         {
             st2_.emplace( mp_size_t<J>(), std::forward<A>(a)... );
-            ix_ = -static_cast<int>( J );
+            ix_ = static_cast<index_type>( -static_cast<int>( J ) );
         }
         else
         {
@@ -611,27 +1173,47 @@ template<class... T> struct variant_base_impl<true, false, T...>
             ix_ = J;
         }
     }
+
+    // swaps alternative I, held by *this, with alternative J, held by r,
+    // by moving each into the other's spare buffer; both moves must be nothrow
+
+    template<std::size_t I, std::size_t J> void _swap_cross( variant_base_impl& r ) noexcept
+    {
+        constexpr mp_size_t<I+1> i{};
+        constexpr mp_size_t<J+1> j{};
+
+        ( ix_ >= 0? st2_: st1_ ).emplace( j, std::move( r._get_impl( mp_size_t<J>() ) ) );
+        ( r.ix_ >= 0? r.st2_: r.st1_ ).emplace( i, std::move( this->_get_impl( mp_size_t<I>() ) ) );
+
+        ix_ = static_cast<index_type>( ix_ >= 0? -static_cast<int>( J+1 ): static_cast<int>( J+1 ) );
+        r.ix_ = static_cast<index_type>( r.ix_ >= 0? -static_cast<int>( I+1 ): static_cast<int>( I+1 ) );
+    }
 };
 
 // not trivially destructible, single buffered
-template<class... T> struct variant_base_impl<false, true, T...>
+template<class... T> struct variant_base_impl<false, true, T...>: variant_fields<smallest_unsigned_type<sizeof...(T)>, variant_storage<none, T...>, 1>
 {
-    int ix_;
-    variant_storage<none, T...> st1_;
+    using index_type = smallest_unsigned_type<sizeof...(T)>;
+    using fields = variant_fields<index_type, variant_storage<none, T...>, 1>;
 
-    constexpr variant_base_impl(): ix_( 0 ), st1_( mp_size_t<0>() )
+    using fields::ix_;
+    using fields::st1_;
+
+    constexpr variant_base_impl(): fields( mp_size_t<0>() )
     {
     }
 
-    template<class I, class... A> constexpr explicit variant_base_impl( I, A&&... a ): ix_( I::value + 1 ), st1_( mp_size_t<I::value + 1>(), std::forward<A>(a)... )
+    template<class I, class... A> constexpr explicit variant_base_impl( I, A&&... a ): fields( mp_size_t<I::value + 1>(), std::forward<A>(a)... )
     {
     }
 
     void _destroy() noexcept
     {
-        if( ix_ > 0 )
+        constexpr std::uint64_t m = variant2::detail::alternative_mask<std::is_trivially_destructible, none, T...>();
+
+        if( !variant2::detail::test_mask( m, ix_ ) )
         {
-            mp_with_index<1 + sizeof...(T)>( ix_, [&]( auto I ){
+            variant2::detail::dispatch_alternative<mp_list<none, T...>>( ix_, [&]( auto I ){
 
                 using U = mp_at_c<mp_list<none, T...>, I>;
                 st1_.get( I ).~U();
@@ -715,40 +1297,43 @@ template<class... T> struct variant_base_impl<false, true, T...>
 };
 
 // not trivially destructible, double buffered
-template<class... T> struct variant_base_impl<false, false, T...>
+template<class... T> struct variant_base_impl<false, false, T...>: variant_fields<smallest_signed_type<sizeof...(T)>, variant_storage<none, T...>, 2>
 {
-    int ix_;
-    variant_storage<none, T...> st1_;
-    variant_storage<none, T...> st2_;
+    using index_type = smallest_signed_type<sizeof...(T)>;
+    using fields = variant_fields<index_type, variant_storage<none, T...>, 2>;
 
-    constexpr variant_base_impl(): ix_( 0 ), st1_( mp_size_t<0>() ), st2_( mp_size_t<0>() )
+    using fields::ix_;
+    using fields::st1_;
+    using fields::st2_;
+
+    constexpr variant_base_impl(): fields( mp_size_t<0>() )
     {
     }
 
-    template<class I, class... A> constexpr explicit variant_base_impl( I, A&&... a ): ix_( I::value + 1 ), st1_( mp_size_t<I::value + 1>(), std::forward<A>(a)... ), st2_( mp_size_t<0>() )
+    template<class I, class... A> constexpr explicit variant_base_impl( I, A&&... a ): fields( mp_size_t<I::value + 1>(), std::forward<A>(a)... )
     {
     }
 
     void _destroy() noexcept
     {
-        if( ix_ > 0 )
-        {
-            mp_with_index<1 + sizeof...(T)>( ix_, [&]( auto I ){
+        constexpr std::uint64_t m = variant2::detail::alternative_mask<std::is_trivially_destructible, none, T...>();
 
-                using U = mp_at_c<mp_list<none, T...>, I>;
-                st1_.get( I ).~U();
+        std::size_t const j = ix_ >= 0? ix_: -ix_;
 
-            });
-        }
-        else if( ix_ < 0 )
-        {
-            mp_with_index<1 + sizeof...(T)>( -ix_, [&]( auto I ){
+        if( variant2::detail::test_mask( m, j ) ) return;
 
-                using U = mp_at_c<mp_list<none, T...>, I>;
-                st2_.get( I ).~U();
+        // select the buffer before the dispatch, rather than dispatching
+        // in each of two branches, since which buffer holds the value is
+        // hard to predict
 
-            });
-        }
+        auto& st = ix_ > 0? st1_: st2_;
+
+        variant2::detail::dispatch_alternative<mp_list<none, T...>>( j, [&]( auto I ){
+
+            using U = mp_at_c<mp_list<none, T...>, I>;
+            st.get( I ).~U();
+
+        });
     }
 
     ~variant_base_impl() noexcept
@@ -781,567 +1366,1749 @@ template<class... T> struct variant_base_impl<false, false, T...>
         return ix_ >= 0? st1_.get( j ): st2_.get( j );
     }
 
+    // destroys the current alternative and constructs the new one in its
+    // buffer when that can't throw, so that the spare buffer stays cold;
+    // otherwise constructs in the spare buffer first, and destroys after
+
     template<std::size_t I, class... A> void emplace( A&&... a )
     {
         size_t const J = I+1;
 
-        if( ix_ >= 0 )
+        using U = mp_at_c<variant<T...>, I>;
+
+        bool const first = ix_ >= 0;
+
+        if( std::is_nothrow_constructible<U, A...>::value )
         {
-            st2_.emplace( mp_size_t<J>(), std::forward<A>(a)... );
             _destroy();
 
-            ix_ = -static_cast<int>( J );
+            ( first? st1_: st2_ ).emplace( mp_size_t<J>(), std::forward<A>(a)... );
+            ix_ = static_cast<index_type>( first? static_cast<int>( J ): -static_cast<int>( J ) );
         }
         else
         {
-            st1_.emplace( mp_size_t<J>(), std::forward<A>(a)... );
+            ( first? st2_: st1_ ).emplace( mp_size_t<J>(), std::forward<A>(a)... );
             _destroy();
 
-            ix_ = J;
+            ix_ = static_cast<index_type>( first? -static_cast<int>( J ): static_cast<int>( J ) );
         }
     }
-};
 
-} // namespace detail
-
-// in_place_type_t
+    // swaps alternative I, held by *this, with alternative J, held by r,
+    // by moving each into the other's spare buffer; both moves must be nothrow
 
-template<class T> struct in_place_type_t
-{
-};
+    template<std::size_t I, std::size_t J> void _swap_cross( variant_base_impl& r ) noexcept
+    {
+        constexpr mp_size_t<I+1> i{};
+        constexpr mp_size_t<J+1> j{};
 
-template<class T> constexpr in_place_type_t<T> in_place_type{};
+        ( ix_ >= 0? st2_: st1_ ).emplace( j, std::move( r._get_impl( mp_size_t<J>() ) ) );
+        ( r.ix_ >= 0? r.st2_: r.st1_ ).emplace( i, std::move( this->_get_impl( mp_size_t<I>() ) ) );
 
-namespace detail
-{
+        _destroy();
+        r._destroy();
 
-template<class T> struct is_in_place_type: std::false_type {};
-template<class T> struct is_in_place_type<in_place_type_t<T>>: std::true_type {};
+        ix_ = static_cast<index_type>( ix_ >= 0? -static_cast<int>( J+1 ): static_cast<int>( J+1 ) );
+        r.ix_ = static_cast<index_type>( r.ix_ >= 0? -static_cast<int>( I+1 ): static_cast<int>( I+1 ) );
+    }
+};
 
-} // namespace detail
+// construct_trivial
+//
+// Copies the alternative held by r into b, which holds none, as bytes, when
+// the bit index() + 1 of M is set; returns whether it did. Storage larger
+// than a cache line is copied only as far as the alternative extends
 
-// in_place_index_t
+template<std::uint64_t M, class B> constexpr bool construct_trivial( B &, B const & ) noexcept
+{
+    return false;
+}
 
-template<std::size_t I> struct in_place_index_t
+template<std::uint64_t M, bool D, class... T> bool construct_trivial( variant_base_impl<D, true, T...> & b, variant_base_impl<D, true, T...> const & r ) noexcept
 {
-};
+    if( !test_mask( M, r.ix_ ) ) return false;
 
-template<std::size_t I> constexpr in_place_index_t<I> in_place_index{};
+    std::memcpy( static_cast<void*>( &b.st1_ ), &r.st1_, sizeof( b.st1_ ) <= 64? sizeof( b.st1_ ): alternative_sizes<none, T...>::value[ r.ix_ ] );
+    b.ix_ = r.ix_;
 
-namespace detail
+    return true;
+}
+
+template<std::uint64_t M, bool D, class... T> bool construct_trivial( variant_base_impl<D, false, T...> & b, variant_base_impl<D, false, T...> const & r ) noexcept
 {
+    std::size_t j = r.ix_ >= 0? r.ix_: -r.ix_;
 
-template<class T> struct is_in_place_index: std::false_type {};
-template<std::size_t I> struct is_in_place_index<in_place_index_t<I>>: std::true_type {};
+    if( !test_mask( M, j ) ) return false;
 
-} // namespace detail
+    std::memcpy( static_cast<void*>( &b.st1_ ), r.ix_ >= 0? &r.st1_: &r.st2_, sizeof( b.st1_ ) <= 64? sizeof( b.st1_ ): alternative_sizes<none, T...>::value[ j ] );
+    b.ix_ = static_cast<decltype( b.ix_ )>( j );
 
-// is_nothrow_swappable
+    return true;
+}
 
-namespace detail
-{
+// heap backup
+//
+// ix_ > 0: the alternative ix_ - 1 is in st1_
+// ix_ < 0: the alternative -ix_ - 1 is on the heap, pointed to by the void* in st1_
 
-namespace det2
+template<class... T> struct variant_backup_base: variant_fields<smallest_signed_type<sizeof...(T)>, variant_storage<none, T..., void*>, 1>
 {
+    using index_type = smallest_signed_type<sizeof...(T)>;
+    using fields = variant_fields<index_type, variant_storage<none, T..., void*>, 1>;
 
-using std::swap;
+    using fields::ix_;
+    using fields::st1_;
 
-template<class T> using is_swappable_impl = decltype(swap(std::declval<T&>(), std::declval<T&>()));
+    using backup_ = mp_size_t<1 + sizeof...(T)>;
 
-#if BOOST_WORKAROUND( BOOST_MSVC, <= 1910 )
+    variant_backup_base(): fields( mp_size_t<0>() )
+    {
+    }
 
-template<class T> struct is_nothrow_swappable_impl_
-{
-    static constexpr bool value = noexcept(swap(std::declval<T&>(), std::declval<T&>()));
-};
+    template<class I, class... A> explicit variant_backup_base( I, A&&... a ): fields( mp_size_t<I::value + 1>(), std::forward<A>(a)... )
+    {
+    }
 
-template<class T> using is_nothrow_swappable_impl = mp_bool< is_nothrow_swappable_impl_<T>::value >;
+    variant_backup_base( variant_backup_base const& r ): fields( mp_size_t<0>() )
+    {
+        variant2::detail::dispatch_alternative<mp_list<T...>>( r.index(), [&]( auto I ){
 
-#else
+            this->st1_.emplace( mp_size_t<I + 1>(), r._get_impl( I ) );
+            this->ix_ = I + 1;
 
-template<class T> using is_nothrow_swappable_impl = std::enable_if_t<noexcept(swap(std::declval<T&>(), std::declval<T&>()))>;
+        });
+    }
 
-#endif
+    variant_backup_base( variant_backup_base&& r ): fields( mp_size_t<0>() )
+    {
+        variant2::detail::dispatch_alternative<mp_list<T...>>( r.index(), [&]( auto I ){
 
-} // namespace det2
+            this->st1_.emplace( mp_size_t<I + 1>(), std::move( r._get_impl( I ) ) );
+            this->ix_ = I + 1;
 
-template<class T> struct is_swappable: mp_valid<det2::is_swappable_impl, T>
-{
-};
+        });
+    }
 
-#if BOOST_WORKAROUND( BOOST_MSVC, <= 1910 )
+    variant_backup_base& operator=( variant_backup_base const& r )
+    {
+        variant2::detail::dispatch_alternative<mp_list<T...>>( r.index(), [&]( auto I ){
 
-template<class T> struct is_nothrow_swappable: mp_eval_if<mp_not<is_swappable<T>>, mp_false, det2::is_nothrow_swappable_impl, T>
-{
-};
+            if( this->index() == I )
+            {
+                this->_get_impl( I ) = r._get_impl( I );
+            }
+            else
+            {
+                this->template emplace<I>( r._get_impl( I ) );
+            }
 
-#else
+        });
 
-template<class T> struct is_nothrow_swappable: mp_valid<det2::is_nothrow_swappable_impl, T>
-{
-};
+        return *this;
+    }
 
-#endif
+    variant_backup_base& operator=( variant_backup_base&& r )
+    {
+        variant2::detail::dispatch_alternative<mp_list<T...>>( r.index(), [&]( auto I ){
 
-} // namespace detail
+            if( this->index() == I )
+            {
+                this->_get_impl( I ) = std::move( r._get_impl( I ) );
+            }
+            else
+            {
+                this->template emplace<I>( std::move( r._get_impl( I ) ) );
+            }
 
-// variant
+        });
 
-template<class... T> class variant: private variant2::detail::variant_base<T...>
-{
-private:
+        return *this;
+    }
 
-    using variant_base = variant2::detail::variant_base<T...>;
+    void _destroy() noexcept
+    {
+        constexpr std::uint64_t m = variant2::detail::alternative_mask<std::is_trivially_destructible, none, T...>();
 
-private:
+        if( ix_ >= 0 )
+        {
+            if( variant2::detail::test_mask( m, ix_ ) ) return;
 
-    variant( variant const volatile& r ) = delete;
-    variant& operator=( variant const volatile& r ) = delete;
+            variant2::detail::dispatch_alternative<mp_list<none, T...>>( ix_, [&]( auto I ){
 
-public:
+                using U = mp_at_c<mp_list<none, T...>, I>;
+                st1_.get( I ).~U();
 
-    // constructors
+            });
+        }
+        else
+        {
+            variant2::detail::dispatch_alternative<mp_list<none, T...>>( -ix_, [&]( auto I ){
 
-    template<class E1 = void, class E2 = mp_if<std::is_default_constructible< mp_first<variant<T...>> >, E1>>
-    constexpr variant()
-        noexcept( std::is_nothrow_default_constructible< mp_first<variant<T...>> >::value )
-        : variant_base( mp_size_t<0>() )
-    {
-    }
+                using U = mp_at_c<mp_list<none, T...>, I>;
+                delete static_cast<U*>( st1_.get( backup_() ) );
 
-    template<class E1 = void,
-        class E2 = mp_if<mp_all<variant2::detail::is_trivially_copy_constructible<T>...>, E1>
-    >
-    constexpr variant( variant const& r ) noexcept
-        : variant_base( static_cast<variant_base const&>(r) )
-    {
+            });
+        }
     }
 
-    template<class E1 = void,
-        class E2 = mp_if<mp_not<mp_all<variant2::detail::is_trivially_copy_constructible<T>...>>, E1>,
-        class E3 = mp_if<mp_all<std::is_copy_constructible<T>...>, E1>
-    >
-    variant( variant const& r )
-        noexcept( mp_all<std::is_nothrow_copy_constructible<T>...>::value )
+    ~variant_backup_base() noexcept
     {
-        mp_with_index<sizeof...(T)>( r.index(), [&]( auto I ){
-
-            ::new( static_cast<variant_base*>(this) ) variant_base( I, r._get_impl( I ) );
-
-        });
+        _destroy();
     }
 
-    template<class E1 = void,
-        class E2 = mp_if<mp_all<variant2::detail::is_trivially_move_constructible<T>...>, E1>
-    >
-    constexpr variant( variant && r ) noexcept
-        : variant_base( static_cast<variant_base&&>(r) )
+    constexpr std::size_t index() const noexcept
     {
+        return ix_ >= 0? ix_ - 1: -ix_ - 1;
     }
 
-    template<class E1 = void,
-        class E2 = mp_if<mp_not<mp_all<variant2::detail::is_trivially_move_constructible<T>...>>, E1>,
-        class E3 = mp_if<mp_all<std::is_move_constructible<T>...>, E1>
-    >
-    variant( variant && r )
-        noexcept( mp_all<std::is_nothrow_move_constructible<T>...>::value )
+    template<std::size_t I> mp_at_c<variant<T...>, I>& _get_impl( mp_size_t<I> ) noexcept
     {
-        mp_with_index<sizeof...(T)>( r.index(), [&]( auto I ){
-
-            ::new( static_cast<variant_base*>(this) ) variant_base( I, std::move( r._get_impl( I ) ) );
-
-        });
-    }
+        size_t const J = I+1;
 
-    template<class U,
-        class Ud = std::decay_t<U>,
-        class E1 = std::enable_if_t< !std::is_same<Ud, variant>::value && !variant2::detail::is_in_place_index<Ud>::value && !variant2::detail::is_in_place_type<Ud>::value >,
-        class V = variant2::detail::resolve_overload_type<U&&, T...>,
-        class E2 = std::enable_if_t<std::is_constructible<V, U>::value>
-        >
-    constexpr variant( U&& u )
-        noexcept( std::is_nothrow_constructible<V, U>::value )
-        : variant_base( variant2::detail::resolve_overload_index<U&&, T...>(), std::forward<U>(u) )
-    {
-    }
+        assert( ix_ == J || -ix_ == J );
 
-    template<class U, class... A, class I = mp_find<variant<T...>, U>, class E = std::enable_if_t<std::is_constructible<U, A...>::value>>
-    constexpr explicit variant( in_place_type_t<U>, A&&... a ): variant_base( I(), std::forward<A>(a)... )
-    {
+        using U = mp_at_c<variant<T...>, I>;
+        return ix_ >= 0? st1_.get( mp_size_t<J>() ): *static_cast<U*>( st1_.get( backup_() ) );
     }
 
-    template<class U, class V, class... A, class I = mp_find<variant<T...>, U>, class E = std::enable_if_t<std::is_constructible<U, std::initializer_list<V>&, A...>::value>>
-    constexpr explicit variant( in_place_type_t<U>, std::initializer_list<V> il, A&&... a ): variant_base( I(), il, std::forward<A>(a)... )
+    template<std::size_t I> mp_at_c<variant<T...>, I> const& _get_impl( mp_size_t<I> ) const noexcept
     {
-    }
+        size_t const J = I+1;
 
-    template<std::size_t I, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<variant<T...>, I>, A...>::value>>
-    constexpr explicit variant( in_place_index_t<I>, A&&... a ): variant_base( mp_size_t<I>(), std::forward<A>(a)... )
-    {
-    }
+        assert( ix_ == J || -ix_ == J );
 
-    template<std::size_t I, class V, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<variant<T...>, I>, std::initializer_list<V>&, A...>::value>>
-    constexpr explicit variant( in_place_index_t<I>, std::initializer_list<V> il, A&&... a ): variant_base( mp_size_t<I>(), il, std::forward<A>(a)... )
-    {
+        using U = mp_at_c<variant<T...>, I>;
+        return ix_ >= 0? st1_.get( mp_size_t<J>() ): *static_cast<U const*>( st1_.get( backup_() ) );
     }
 
-    // assignment
-    template<class E1 = void,
-        class E2 = mp_if<mp_all<std::is_trivially_destructible<T>..., variant2::detail::is_trivially_copy_assignable<T>...>, E1>
-    >
-    constexpr variant& operator=( variant const & r ) noexcept
-    {
-        static_cast<variant_base&>( *this ) = static_cast<variant_base const&>( r );
-        return *this;
-    }
+    // the alternative K in st1_ is nothrow move constructible; back it up on the stack
 
-    template<class E1 = void,
-        class E2 = mp_if<mp_not<mp_all<std::is_trivially_destructible<T>..., variant2::detail::is_trivially_copy_assignable<T>...>>, E1>,
-        class E3 = mp_if<mp_all<std::is_copy_constructible<T>..., std::is_copy_assignable<T>...>, E1>
-    >
-    constexpr variant& operator=( variant const & r )
-        noexcept( mp_all<std::is_nothrow_copy_constructible<T>..., std::is_nothrow_copy_assignable<T>...>::value )
+    template<std::size_t J, std::size_t K, class... A> void _emplace_with_backup( mp_size_t<K>, mp_true, A&&... a )
     {
-        mp_with_index<sizeof...(T)>( r.index(), [&]( auto I ){
+        using W = mp_at_c<mp_list<none, T...>, K>;
 
-            if( this->index() == I )
-            {
-                this->_get_impl( I ) = r._get_impl( I );
-            }
-            else
-            {
-                this->variant_base::template emplace<I>( r._get_impl( I ) );
-            }
+        W tmp( std::move( st1_.get( mp_size_t<K>() ) ) );
+        st1_.get( mp_size_t<K>() ).~W();
 
-        });
+        try
+        {
+            st1_.emplace( mp_size_t<J>(), std::forward<A>(a)... );
+        }
+        catch( ... )
+        {
+            st1_.emplace( mp_size_t<K>(), std::move(tmp) );
+            throw;
+        }
 
-        return *this;
+        ix_ = J;
     }
 
-    template<class E1 = void,
-        class E2 = mp_if<mp_all<std::is_trivially_destructible<T>..., variant2::detail::is_trivially_move_assignable<T>...>, E1>
-    >
-    constexpr variant& operator=( variant && r ) noexcept
-    {
-        static_cast<variant_base&>( *this ) = static_cast<variant_base&&>( r );
-        return *this;
-    }
+    // otherwise, back it up on the heap, where it stays if the emplacement fails
 
-    template<class E1 = void,
-        class E2 = mp_if<mp_not<mp_all<std::is_trivially_destructible<T>..., variant2::detail::is_trivially_move_assignable<T>...>>, E1>,
-        class E3 = mp_if<mp_all<std::is_move_constructible<T>..., std::is_move_assignable<T>...>, E1>
-    >
-    variant& operator=( variant && r )
-        noexcept( mp_all<std::is_nothrow_move_constructible<T>..., std::is_nothrow_move_assignable<T>...>::value )
+    template<std::size_t J, std::size_t K, class... A> void _emplace_with_backup( mp_size_t<K>, mp_false, A&&... a )
     {
-        mp_with_index<sizeof...(T)>( r.index(), [&]( auto I ){
+        using W = mp_at_c<mp_list<none, T...>, K>;
 
-            if( this->index() == I )
-            {
-                this->_get_impl( I ) = std::move( r._get_impl( I ) );
-            }
-            else
-            {
-                this->variant_base::template emplace<I>( std::move( r._get_impl( I ) ) );
-            }
+        W* p = new W( std::move( st1_.get( mp_size_t<K>() ) ) );
+        st1_.get( mp_size_t<K>() ).~W();
 
-        });
+        try
+        {
+            st1_.emplace( mp_size_t<J>(), std::forward<A>(a)... );
+        }
+        catch( ... )
+        {
+            st1_.emplace( backup_(), p );
+            ix_ = static_cast<index_type>( -static_cast<int>( K ) );
 
-        return *this;
+            throw;
+        }
+
+        ix_ = J;
+        delete p;
     }
 
-    template<class U,
-        class E1 = std::enable_if_t<!std::is_same<std::decay_t<U>, variant>::value>,
-        class V = variant2::detail::resolve_overload_type<U, T...>,
-        class E2 = std::enable_if_t<std::is_assignable<V&, U>::value && std::is_constructible<V, U>::value>
-    >
-    constexpr variant& operator=( U&& u )
-        noexcept( std::is_nothrow_assignable<V&, U>::value && std::is_nothrow_constructible<V, U>::value )
+    // the current alternative is already on the heap
+
+    template<std::size_t J, class... A> void _emplace_over_backup( A&&... a )
     {
-        std::size_t const I = variant2::detail::resolve_overload_index<U, T...>::value;
+        void* p = st1_.get( backup_() );
 
-        if( index() == I )
+        try
         {
-            _get_impl( mp_size_t<I>() ) = std::forward<U>(u);
+            st1_.emplace( mp_size_t<J>(), std::forward<A>(a)... );
         }
-        else
+        catch( ... )
         {
-            this->template emplace<I>( std::forward<U>(u) );
+            st1_.emplace( backup_(), p );
+            throw;
         }
 
-        return *this;
-    }
+        index_type const k = -ix_;
+        ix_ = J;
 
-    // modifiers
+        variant2::detail::dispatch_index<1 + sizeof...(T)>( k, [&]( auto K ){
 
-    template<class U, class... A, class I = mp_find<variant<T...>, U>, class E = std::enable_if_t<std::is_constructible<U, A...>::value>>
-    constexpr U& emplace( A&&... a )
-    {
-        variant_base::template emplace<I::value>( std::forward<A>(a)... );
-        return _get_impl( I() );
-    }
+            using W = mp_at_c<mp_list<none, T...>, K>;
+            delete static_cast<W*>( p );
 
-    template<class U, class V, class... A, class I = mp_find<variant<T...>, U>, class E = std::enable_if_t<std::is_constructible<U, std::initializer_list<V>&, A...>::value>>
-    constexpr U& emplace( std::initializer_list<V> il, A&&... a )
-    {
-        variant_base::template emplace<I::value>( il, std::forward<A>(a)... );
-        return _get_impl( I() );
+        });
     }
 
-    template<std::size_t I, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<variant<T...>, I>, A...>::value>>
-    constexpr variant_alternative_t<I, variant<T...>>& emplace( A&&... a )
+    template<std::size_t I, class... A> void emplace( A&&... a )
     {
-        variant_base::template emplace<I>( std::forward<A>(a)... );
-        return _get_impl( mp_size_t<I>() );
-    }
+        size_t const J = I+1;
 
-    template<std::size_t I, class V, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<variant<T...>, I>, std::initializer_list<V>&, A...>::value>>
-    constexpr variant_alternative_t<I, variant<T...>>& emplace( std::initializer_list<V> il, A&&... a )
-    {
-        variant_base::template emplace<I>( il, std::forward<A>(a)... );
-        return _get_impl( mp_size_t<I>() );
-    }
+        using U = mp_at_c<variant<T...>, I>;
 
-    // value status
+        if( std::is_nothrow_constructible<U, A...>::value )
+        {
+            _destroy();
 
-    using variant_base::index;
+            st1_.emplace( mp_size_t<J>(), std::forward<A>(a)... );
+            ix_ = J;
+        }
+        else if( std::is_nothrow_move_constructible<U>::value )
+        {
+            U tmp( std::forward<A>(a)... );
 
-    // swap
+            _destroy();
 
-    void swap( variant& r ) noexcept( mp_all<std::is_nothrow_move_constructible<T>..., variant2::detail::is_nothrow_swappable<T>...>::value )
-    {
-        if( index() == r.index() )
+            st1_.emplace( mp_size_t<J>(), std::move(tmp) );
+            ix_ = J;
+        }
+        else if( ix_ > 0 )
         {
-            mp_with_index<sizeof...(T)>( index(), [&]( auto I ){
+            variant2::detail::dispatch_index<1 + sizeof...(T)>( ix_, [&]( auto K ){
 
-                using std::swap;
-                swap( this->_get_impl( I ), r._get_impl( I ) );
+                using W = mp_at_c<mp_list<none, T...>, K>;
+                this->template _emplace_with_backup<J>( K, std::is_nothrow_move_constructible<W>(), std::forward<A>(a)... );
 
             });
         }
         else
         {
-            variant tmp( std::move(*this) );
-            *this = std::move( r );
-            r = std::move( tmp );
+            this->template _emplace_over_backup<J>( std::forward<A>(a)... );
         }
     }
+};
 
-    // private accessors
-
-    constexpr int _real_index() const noexcept
-    {
-        return this->ix_;
-    }
+// niche
+template<class... E> struct niche_empties: E...
+{
+};
 
-    using variant_base::_get_impl;
+template<class... T> struct variant_niche_base: mp_rename<mp_remove_if<mp_list<T...>, mp_not_fn<is_niche_empty>::template fn>, niche_empties>
+{
+    static constexpr std::size_t P = niche_payload_index<T...>::value;
 
-    // converting constructors (extension)
+    using payload_type = mp_at_c<mp_list<T...>, P>;
+    using traits = niche_traits<payload_type>;
 
-    template<class... U,
-        class E2 = mp_if<mp_all<std::is_copy_constructible<U>..., mp_contains<mp_list<T...>, U>...>, void> >
-    variant( variant<U...> const& r )
-        noexcept( mp_all<std::is_nothrow_copy_constructible<U>...>::value )
-    {
-        mp_with_index<sizeof...(U)>( r.index(), [&]( auto I ){
+    payload_type p_;
 
-            using J = mp_find<mp_list<T...>, mp_at_c<mp_list<U...>, I>>;
+    // alternative I, I != P, is encoded as the spare value with index I or I-1
 
-            ::new( static_cast<variant_base*>(this) ) variant_base( J{}, r._get_impl( I ) );
+    static constexpr std::size_t spare_for( std::size_t i ) noexcept
+    {
+        return i < P? i: i - 1;
+    }
 
-        });
+    constexpr variant_niche_base(): variant_niche_base( mp_size_t<0>() )
+    {
     }
 
-    template<class... U,
-        class E2 = mp_if<mp_all<std::is_move_constructible<U>..., mp_contains<mp_list<T...>, U>...>, void> >
-    variant( variant<U...> && r )
-        noexcept( mp_all<std::is_nothrow_move_constructible<U>...>::value )
+    template<class... A> constexpr explicit variant_niche_base( mp_size_t<P>, A&&... a ): p_( std::forward<A>(a)... )
     {
-        mp_with_index<sizeof...(U)>( r.index(), [&]( auto I ){
+    }
 
-            using J = mp_find<mp_list<T...>, mp_at_c<mp_list<U...>, I>>;
+    template<std::size_t I, class... A> constexpr explicit variant_niche_base( mp_size_t<I>, A&&... a ): p_( traits::spare( spare_for( I ) ) )
+    {
+        using U = mp_at_c<mp_list<T...>, I>;
+        (void)U( std::forward<A>(a)... );
+    }
 
-            ::new( static_cast<variant_base*>(this) ) variant_base( J{}, std::move( r._get_impl( I ) ) );
+    constexpr std::size_t index() const noexcept
+    {
+        std::size_t const k = traits::spare_index( p_ );
+        return k >= sizeof...(T) - 1? P: k < P? k: k + 1;
+    }
 
-        });
+    constexpr payload_type& _get_impl( mp_size_t<P> ) noexcept
+    {
+        return p_;
     }
 
-    // subset (extension)
+    constexpr payload_type const& _get_impl( mp_size_t<P> ) const noexcept
+    {
+        return p_;
+    }
 
-private:
+    template<std::size_t I> constexpr mp_at_c<mp_list<T...>, I>& _get_impl( mp_size_t<I> ) noexcept
+    {
+        assert( index() == I );
+        return *this;
+    }
 
-    template<class... U, class V, std::size_t J, class E = std::enable_if_t<J != sizeof...(U)>> static constexpr variant<U...> _subset_impl( mp_size_t<J>, V && v )
+    template<std::size_t I> constexpr mp_at_c<mp_list<T...>, I> const& _get_impl( mp_size_t<I> ) const noexcept
     {
-        return variant<U...>( in_place_index<J>, std::forward<V>(v) );
+        assert( index() == I );
+        return *this;
     }
 
-    template<class... U, class V> static variant<U...> _subset_impl( mp_size_t<sizeof...(U)>, V && /*v*/ )
+    template<std::size_t I, class... A> constexpr void emplace_impl( mp_true, A&&... a )
     {
-        throw bad_variant_access();
+        p_ = payload_type( std::forward<A>(a)... );
     }
 
-public:
+    template<std::size_t I, class... A> constexpr void emplace_impl( mp_false, A&&... a )
+    {
+        using U = mp_at_c<mp_list<T...>, I>;
+        (void)U( std::forward<A>(a)... );
 
-    template<class... U,
-        class E2 = mp_if<mp_all<std::is_copy_constructible<U>..., mp_contains<mp_list<T...>, U>...>, void> >
-    constexpr variant<U...> subset() &
+        p_ = traits::spare( spare_for( I ) );
+    }
+
+    template<std::size_t I, class... A> constexpr void emplace( A&&... a )
     {
-        return mp_with_index<sizeof...(T)>( index(), [&]( auto I ){
+        this->emplace_impl<I>( mp_bool<I == P>(), std::forward<A>(a)... );
+    }
+};
 
-            using J = mp_find<mp_list<U...>, mp_at_c<mp_list<T...>, I>>;
+} // namespace detail
 
-            return this->_subset_impl<U...>( J{}, this->_get_impl( I ) );
+// in_place_type_t
 
-        });
+template<class T> struct in_place_type_t
+{
+};
+
+template<class T> constexpr in_place_type_t<T> in_place_type{};
+
+namespace detail
+{
+
+template<class T> struct is_in_place_type: std::false_type {};
+template<class T> struct is_in_place_type<in_place_type_t<T>>: std::true_type {};
+
+} // namespace detail
+
+// in_place_index_t
+
+template<std::size_t I> struct in_place_index_t
+{
+};
+
+template<std::size_t I> constexpr in_place_index_t<I> in_place_index{};
+
+namespace detail
+{
+
+template<class T> struct is_in_place_index: std::false_type {};
+template<std::size_t I> struct is_in_place_index<in_place_index_t<I>>: std::true_type {};
+
+} // namespace detail
+
+// in_place_factory_t
+
+struct in_place_factory_t
+{
+};
+
+constexpr in_place_factory_t in_place_factory{};
+
+// is_nothrow_swappable
+
+namespace detail
+{
+
+namespace det2
+{
+
+using std::swap;
+
+template<class T> using is_swappable_impl = decltype(swap(std::declval<T&>(), std::declval<T&>()));
+
+#if BOOST_WORKAROUND( BOOST_MSVC, <= 1910 )
+
+template<class T> struct is_nothrow_swappable_impl_
+{
+    static constexpr bool value = noexcept(swap(std::declval<T&>(), std::declval<T&>()));
+};
+
+template<class T> using is_nothrow_swappable_impl = mp_bool< is_nothrow_swappable_impl_<T>::value >;
+
+#else
+
+template<class T> using is_nothrow_swappable_impl = std::enable_if_t<noexcept(swap(std::declval<T&>(), std::declval<T&>()))>;
+
+#endif
+
+} // namespace det2
+
+template<class T> struct is_swappable: mp_valid<det2::is_swappable_impl, T>
+{
+};
+
+#if BOOST_WORKAROUND( BOOST_MSVC, <= 1910 )
+
+template<class T> struct is_nothrow_swappable: mp_eval_if<mp_not<is_swappable<T>>, mp_false, det2::is_nothrow_swappable_impl, T>
+{
+};
+
+#else
+
+template<class T> struct is_nothrow_swappable: mp_valid<det2::is_nothrow_swappable_impl, T>
+{
+};
+
+#endif
+
+} // namespace detail
+
+// variant
+
+template<class... T> class variant: private variant2::detail::variant_base<T...>
+{
+private:
+
+    using variant_base = variant2::detail::variant_base<T...>;
+
+private:
+
+    variant( variant const volatile& r ) = delete;
+    variant& operator=( variant const volatile& r ) = delete;
+
+public:
+
+    // constructors
+
+    template<class E1 = void, class E2 = mp_if<std::is_default_constructible< mp_first<variant<T...>> >, E1>>
+    constexpr variant()
+        noexcept( std::is_nothrow_default_constructible< mp_first<variant<T...>> >::value )
+        : variant_base( mp_size_t<0>() )
+    {
     }
 
-    template<class... U,
-        class E2 = mp_if<mp_all<std::is_copy_constructible<U>..., mp_contains<mp_list<T...>, U>...>, void> >
-    constexpr variant<U...> subset() const&
+    template<class E1 = void,
+        class E2 = mp_if<mp_all<variant2::detail::is_trivially_copy_constructible<T>...>, E1>
+    >
+    constexpr variant( variant const& r ) noexcept
+        : variant_base( static_cast<variant_base const&>(r) )
     {
-        return mp_with_index<sizeof...(T)>( index(), [&]( auto I ){
+    }
 
-            using J = mp_find<mp_list<U...>, mp_at_c<mp_list<T...>, I>>;
+    template<class E1 = void,
+        class E2 = mp_if<mp_not<mp_all<variant2::detail::is_trivially_copy_constructible<T>...>>, E1>,
+        class E3 = mp_if<mp_all<std::is_copy_constructible<T>...>, E1>
+    >
+    variant( variant const& r )
+        noexcept( mp_all<std::is_nothrow_copy_constructible<T>...>::value )
+    {
+        constexpr std::uint64_t m = variant2::detail::alternative_mask<variant2::detail::is_trivially_copyable_alternative, variant2::detail::none, T...>();
 
-            return this->_subset_impl<U...>( J{}, this->_get_impl( I ) );
+        if( variant2::detail::construct_trivial<m>( static_cast<variant_base&>( *this ), static_cast<variant_base const&>( r ) ) ) return;
+
+        variant2::detail::dispatch_alternative<mp_list<T...>>( r.index(), [&]( auto I ){
+
+            ::new( static_cast<variant_base*>(this) ) variant_base( I, r._get_impl( I ) );
 
         });
     }
 
-    template<class... U,
-        class E2 = mp_if<mp_all<std::is_copy_constructible<U>..., mp_contains<mp_list<T...>, U>...>, void> >
-    constexpr variant<U...> subset() &&
+    template<class E1 = void,
+        class E2 = mp_if<mp_all<variant2::detail::is_trivially_move_constructible<T>...>, E1>
+    >
+    constexpr variant( variant && r ) noexcept
+        : variant_base( static_cast<variant_base&&>(r) )
     {
-        return mp_with_index<sizeof...(T)>( index(), [&]( auto I ){
+    }
 
-            using J = mp_find<mp_list<U...>, mp_at_c<mp_list<T...>, I>>;
+    template<class E1 = void,
+        class E2 = mp_if<mp_not<mp_all<variant2::detail::is_trivially_move_constructible<T>...>>, E1>,
+        class E3 = mp_if<mp_all<std::is_move_constructible<T>...>, E1>
+    >
+    variant( variant && r )
+        noexcept( mp_all<std::is_nothrow_move_constructible<T>...>::value )
+    {
+        constexpr std::uint64_t m = variant2::detail::alternative_mask<variant2::detail::is_trivially_movable_alternative, variant2::detail::none, T...>();
 
-            return this->_subset_impl<U...>( J{}, std::move( this->_get_impl( I ) ) );
+        if( variant2::detail::construct_trivial<m>( static_cast<variant_base&>( *this ), static_cast<variant_base const&>( r ) ) ) return;
+
+        variant2::detail::dispatch_alternative<mp_list<T...>>( r.index(), [&]( auto I ){
+
+            ::new( static_cast<variant_base*>(this) ) variant_base( I, std::move( r._get_impl( I ) ) );
 
         });
     }
 
-    template<class... U,
-        class E2 = mp_if<mp_all<std::is_copy_constructible<U>..., mp_contains<mp_list<T...>, U>...>, void> >
-    constexpr variant<U...> subset() const&&
+    template<class U,
+        class Ud = std::decay_t<U>,
+        class E1 = std::enable_if_t< !std::is_same<Ud, variant>::value && !variant2::detail::is_in_place_index<Ud>::value && !variant2::detail::is_in_place_type<Ud>::value >,
+        class V = variant2::detail::resolve_overload_type<U&&, T...>,
+        class E2 = std::enable_if_t<std::is_constructible<V, U>::value>
+        >
+    constexpr variant( U&& u )
+        noexcept( std::is_nothrow_constructible<V, U>::value )
+        : variant_base( variant2::detail::resolve_overload_index<U&&, T...>(), std::forward<U>(u) )
     {
-        return mp_with_index<sizeof...(T)>( index(), [&]( auto I ){
+    }
 
-            using J = mp_find<mp_list<U...>, mp_at_c<mp_list<T...>, I>>;
+    template<class U, class... A, class I = mp_find<variant<T...>, U>, class E = std::enable_if_t<std::is_constructible<U, A...>::value>>
+    constexpr explicit variant( in_place_type_t<U>, A&&... a ): variant_base( I(), std::forward<A>(a)... )
+    {
+    }
 
-            return this->_subset_impl<U...>( J{}, std::move( this->_get_impl( I ) ) );
+    template<class U, class V, class... A, class I = mp_find<variant<T...>, U>, class E = std::enable_if_t<std::is_constructible<U, std::initializer_list<V>&, A...>::value>>
+    constexpr explicit variant( in_place_type_t<U>, std::initializer_list<V> il, A&&... a ): variant_base( I(), il, std::forward<A>(a)... )
+    {
+    }
 
-        });
+    template<std::size_t I, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<variant<T...>, I>, A...>::value>>
+    constexpr explicit variant( in_place_index_t<I>, A&&... a ): variant_base( mp_size_t<I>(), std::forward<A>(a)... )
+    {
     }
-};
 
-// relational operators
-template<class... T> constexpr bool operator==( variant<T...> const & v, variant<T...> const & w )
-{
-    if( v.index() != w.index() ) return false;
+    template<std::size_t I, class V, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<variant<T...>, I>, std::initializer_list<V>&, A...>::value>>
+    constexpr explicit variant( in_place_index_t<I>, std::initializer_list<V> il, A&&... a ): variant_base( mp_size_t<I>(), il, std::forward<A>(a)... )
+    {
+    }
 
-    return mp_with_index<sizeof...(T)>( v.index(), [&]( auto I ){
+    // constructs the alternative of the type f() returns from its result;
+    // since C++17, it isn't moved
 
-        return v._get_impl( I ) == w._get_impl( I );
+    template<class F,
+        class R = variant2::detail::factory_result<F>,
+        class I = mp_find<variant<T...>, std::decay_t<R>>,
+        class E = std::enable_if_t<mp_count<variant<T...>, std::decay_t<R>>::value == 1 && variant2::detail::is_factory_constructible<std::decay_t<R>, R>::value>
+    >
+    constexpr explicit variant( in_place_factory_t, F&& f ): variant_base( I(), variant2::detail::factory_arg<F>{ std::forward<F>(f) } )
+    {
+    }
 
-    });
-}
+    // assignment
+    template<class E1 = void,
+        class E2 = mp_if<mp_all<std::is_trivially_destructible<T>..., variant2::detail::is_trivially_copy_assignable<T>...>, E1>
+    >
+    constexpr variant& operator=( variant const & r ) noexcept
+    {
+        static_cast<variant_base&>( *this ) = static_cast<variant_base const&>( r );
+        return *this;
+    }
 
-template<class... T> constexpr bool operator!=( variant<T...> const & v, variant<T...> const & w )
-{
-    if( v.index() != w.index() ) return true;
+    template<class E1 = void,
+        class E2 = mp_if<mp_not<mp_all<std::is_trivially_destructible<T>..., variant2::detail::is_trivially_copy_assignable<T>...>>, E1>,
+        class E3 = mp_if<mp_all<std::is_copy_constructible<T>..., std::is_copy_assignable<T>...>, E1>
+    >
+    constexpr variant& operator=( variant const & r )
+        noexcept( mp_all<std::is_nothrow_copy_constructible<T>..., std::is_nothrow_copy_assignable<T>...>::value )
+    {
+        variant2::detail::dispatch_alternative<mp_list<T...>>( r.index(), [&]( auto I ){
+
+            if( this->index() == I )
+            {
+                this->_get_impl( I ) = r._get_impl( I );
+            }
+            else
+            {
+                this->variant_base::template emplace<I>( r._get_impl( I ) );
+            }
 
-    return mp_with_index<sizeof...(T)>( v.index(), [&]( auto I ){
+        });
 
-        return v._get_impl( I ) != w._get_impl( I );
+        return *this;
+    }
 
-    });
+    template<class E1 = void,
+        class E2 = mp_if<mp_all<std::is_trivially_destructible<T>..., variant2::detail::is_trivially_move_assignable<T>...>, E1>
+    >
+    constexpr variant& operator=( variant && r ) noexcept
+    {
+        static_cast<variant_base&>( *this ) = static_cast<variant_base&&>( r );
+        return *this;
+    }
+
+    template<class E1 = void,
+        class E2 = mp_if<mp_not<mp_all<std::is_trivially_destructible<T>..., variant2::detail::is_trivially_move_assignable<T>...>>, E1>,
+        class E3 = mp_if<mp_all<std::is_move_constructible<T>..., std::is_move_assignable<T>...>, E1>
+    >
+    variant& operator=( variant && r )
+        noexcept( mp_all<std::is_nothrow_move_constructible<T>..., std::is_nothrow_move_assignable<T>...>::value )
+    {
+        variant2::detail::dispatch_alternative<mp_list<T...>>( r.index(), [&]( auto I ){
+
+            if( this->index() == I )
+            {
+                this->_get_impl( I ) = std::move( r._get_impl( I ) );
+            }
+            else
+            {
+                this->variant_base::template emplace<I>( std::move( r._get_impl( I ) ) );
+            }
+
+        });
+
+        return *this;
+    }
+
+    template<class U,
+        class E1 = std::enable_if_t<!std::is_same<std::decay_t<U>, variant>::value>,
+        class V = variant2::detail::resolve_overload_type<U, T...>,
+        class E2 = std::enable_if_t<std::is_assignable<V&, U>::value && std::is_constructible<V, U>::value>
+    >
+    constexpr variant& operator=( U&& u )
+        noexcept( std::is_nothrow_assignable<V&, U>::value && std::is_nothrow_constructible<V, U>::value )
+    {
+        std::size_t const I = variant2::detail::resolve_overload_index<U, T...>::value;
+
+        if( index() == I )
+        {
+            _get_impl( mp_size_t<I>() ) = std::forward<U>(u);
+        }
+        else
+        {
+            this->template emplace<I>( std::forward<U>(u) );
+        }
+
+        return *this;
+    }
+
+    // modifiers
+
+    template<class U, class... A, class I = mp_find<variant<T...>, U>, class E = std::enable_if_t<std::is_constructible<U, A...>::value>>
+    constexpr U& emplace( A&&... a )
+    {
+        variant_base::template emplace<I::value>( std::forward<A>(a)... );
+        return _get_impl( I() );
+    }
+
+    template<class U, class V, class... A, class I = mp_find<variant<T...>, U>, class E = std::enable_if_t<std::is_constructible<U, std::initializer_list<V>&, A...>::value>>
+    constexpr U& emplace( std::initializer_list<V> il, A&&... a )
+    {
+        variant_base::template emplace<I::value>( il, std::forward<A>(a)... );
+        return _get_impl( I() );
+    }
+
+    template<std::size_t I, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<variant<T...>, I>, A...>::value>>
+    constexpr variant_alternative_t<I, variant<T...>>& emplace( A&&... a )
+    {
+        variant_base::template emplace<I>( std::forward<A>(a)... );
+        return _get_impl( mp_size_t<I>() );
+    }
+
+    template<std::size_t I, class V, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<variant<T...>, I>, std::initializer_list<V>&, A...>::value>>
+    constexpr variant_alternative_t<I, variant<T...>>& emplace( std::initializer_list<V> il, A&&... a )
+    {
+        variant_base::template emplace<I>( il, std::forward<A>(a)... );
+        return _get_impl( mp_size_t<I>() );
+    }
+
+    // emplace_with
+    //
+    // Constructs the alternative from the result of f(); since C++17, a
+    // prvalue of the alternative's type is constructed directly in place,
+    // unless emplace needs a temporary to keep the old value if it throws
+
+    template<class U, class F, class I = mp_find<variant<T...>, U>, class E = std::enable_if_t<I::value != sizeof...(T) && variant2::detail::is_factory_constructible<U, variant2::detail::factory_result<F>>::value>>
+    constexpr U& emplace_with( F&& f )
+    {
+        variant_base::template emplace<I::value>( variant2::detail::factory_arg<F>{ std::forward<F>(f) } );
+        return _get_impl( I() );
+    }
+
+    template<std::size_t I, class F, class E = std::enable_if_t<variant2::detail::is_factory_constructible<mp_at_c<variant<T...>, I>, variant2::detail::factory_result<F>>::value>>
+    constexpr variant_alternative_t<I, variant<T...>>& emplace_with( F&& f )
+    {
+        variant_base::template emplace<I>( variant2::detail::factory_arg<F>{ std::forward<F>(f) } );
+        return _get_impl( mp_size_t<I>() );
+    }
+
+    // value status
+
+    using variant_base::index;
+
+    // swap
+
+private:
+
+    // trivially relocatable, swap the bytes
+    void _swap_impl( variant& r, mp_true ) noexcept
+    {
+        alignas( variant ) unsigned char tmp[ sizeof( variant ) ];
+
+        std::memcpy( tmp, static_cast<void*>( this ), sizeof( variant ) );
+        std::memcpy( static_cast<void*>( this ), static_cast<void const*>( &r ), sizeof( variant ) );
+        std::memcpy( static_cast<void*>( &r ), tmp, sizeof( variant ) );
+    }
+
+    void _swap_impl( variant& r, mp_false )
+    {
+        if( index() == r.index() )
+        {
+            variant2::detail::dispatch_index<sizeof...(T)>( index(), [&]( auto I ){
+
+                using std::swap;
+                swap( this->_get_impl( I ), r._get_impl( I ) );
+
+            });
+        }
+        else
+        {
+            _swap_cross( r, mp_bool<( sizeof...(T) * sizeof...(T) <= BOOST_VARIANT2_MAX_FLAT_VISIT )>() );
+        }
+    }
+
+    // different indices; dispatch once on index() * N + r.index(), as visit does
+    void _swap_cross( variant& r, mp_true )
+    {
+        constexpr std::size_t N = sizeof...(T);
+
+        variant2::detail::dispatch_index<N * N>( index() * N + r.index(), [&]( auto K ){
+
+            this->template _swap_alternatives<decltype(K)::value / N, decltype(K)::value % N>( r );
+
+        });
+    }
+
+    // too many combinations, dispatch on each index
+    void _swap_cross( variant& r, mp_false )
+    {
+        variant2::detail::dispatch_index<sizeof...(T)>( index(), [&]( auto I ){
+
+            variant2::detail::dispatch_index<sizeof...(T)>( r.index(), [&]( auto J ){
+
+                this->template _swap_alternatives<I, J>( r );
+
+            });
+
+        });
+    }
+
+    template<std::size_t I, std::size_t J> void _swap_alternatives( variant& r )
+    {
+        using U = mp_at_c<variant<T...>, I>;
+        using V = mp_at_c<variant<T...>, J>;
+
+        _swap_alternatives<I, J>( r, mp_all<variant2::detail::has_spare_buffer<variant_base>, std::is_nothrow_move_constructible<U>, std::is_nothrow_move_constructible<V>>() );
+    }
+
+    // different indices, double buffered, nothrow moves; each alternative goes into the spare buffer of the other variant
+    template<std::size_t I, std::size_t J> void _swap_alternatives( variant& r, mp_true ) noexcept
+    {
+        this->variant_base::template _swap_cross<I, J>( r );
+    }
+
+    // different indices otherwise; move one alternative out of the way, the
+    // one whose move can throw first, so that if it throws neither variant changes
+    template<std::size_t I, std::size_t J> void _swap_alternatives( variant& r, mp_false )
+    {
+        using U = mp_at_c<variant<T...>, I>;
+        using V = mp_at_c<variant<T...>, J>;
+
+        _swap_through_temporary<I, J>( r, mp_all<std::is_nothrow_move_constructible<U>, mp_not<std::is_nothrow_move_constructible<V>>>() );
+    }
+
+    template<std::size_t I, std::size_t J> void _swap_through_temporary( variant& r, mp_true )
+    {
+        r.template _swap_through_temporary<J, I>( *this, mp_false() );
+    }
+
+    template<std::size_t I, std::size_t J> void _swap_through_temporary( variant& r, mp_false )
+    {
+        using U = mp_at_c<variant<T...>, I>;
+
+        U tmp( std::move( this->_get_impl( mp_size_t<I>() ) ) );
+
+        this->variant_base::template emplace<J>( std::move( r._get_impl( mp_size_t<J>() ) ) );
+        r.variant_base::template emplace<I>( std::move( tmp ) );
+    }
+
+public:
+
+    void swap( variant& r ) noexcept( mp_any<is_trivially_relocatable<variant>, mp_all<std::is_nothrow_move_constructible<T>..., variant2::detail::is_nothrow_swappable<T>...>>::value )
+    {
+        _swap_impl( r, is_trivially_relocatable<variant>() );
+    }
+
+    // private accessors
+
+    constexpr int _real_index() const noexcept
+    {
+        return this->ix_;
+    }
+
+    // the address of the storage, shared by all alternatives; only for
+    // single buffered variants that aren't niche variants
+
+    void const * _storage() const noexcept
+    {
+        return &this->st1_;
+    }
+
+    using variant_base::_get_impl;
+
+    // converting constructors (extension)
+
+    template<class... U,
+        class E2 = mp_if<mp_all<std::is_copy_constructible<U>..., mp_contains<mp_list<T...>, U>...>, void> >
+    variant( variant<U...> const& r )
+        noexcept( mp_all<std::is_nothrow_copy_constructible<U>...>::value )
+    {
+        variant2::detail::dispatch_index<sizeof...(U)>( r.index(), [&]( auto I ){
+
+            using J = mp_find<mp_list<T...>, mp_at_c<mp_list<U...>, I>>;
+
+            ::new( static_cast<variant_base*>(this) ) variant_base( J{}, r._get_impl( I ) );
+
+        });
+    }
+
+    template<class... U,
+        class E2 = mp_if<mp_all<std::is_move_constructible<U>..., mp_contains<mp_list<T...>, U>...>, void> >
+    variant( variant<U...> && r )
+        noexcept( mp_all<std::is_nothrow_move_constructible<U>...>::value )
+    {
+        variant2::detail::dispatch_index<sizeof...(U)>( r.index(), [&]( auto I ){
+
+            using J = mp_find<mp_list<T...>, mp_at_c<mp_list<U...>, I>>;
+
+            ::new( static_cast<variant_base*>(this) ) variant_base( J{}, std::move( r._get_impl( I ) ) );
+
+        });
+    }
+
+    // subset (extension)
+
+private:
+
+    template<class... U, class V, std::size_t J, class E = std::enable_if_t<J != sizeof...(U)>> static constexpr variant<U...> _subset_impl( mp_size_t<J>, V && v )
+    {
+        return variant<U...>( in_place_index<J>, std::forward<V>(v) );
+    }
+
+    template<class... U, class V> static variant<U...> _subset_impl( mp_size_t<sizeof...(U)>, V && /*v*/ )
+    {
+        throw bad_variant_access();
+    }
+
+public:
+
+    template<class... U,
+        class E2 = mp_if<mp_all<std::is_copy_constructible<U>..., mp_contains<mp_list<T...>, U>...>, void> >
+    constexpr variant<U...> subset() &
+    {
+        return variant2::detail::dispatch_index<sizeof...(T)>( index(), [&]( auto I ){
+
+            using J = mp_find<mp_list<U...>, mp_at_c<mp_list<T...>, I>>;
+
+            return this->_subset_impl<U...>( J{}, this->_get_impl( I ) );
+
+        });
+    }
+
+    template<class... U,
+        class E2 = mp_if<mp_all<std::is_copy_constructible<U>..., mp_contains<mp_list<T...>, U>...>, void> >
+    constexpr variant<U...> subset() const&
+    {
+        return variant2::detail::dispatch_index<sizeof...(T)>( index(), [&]( auto I ){
+
+            using J = mp_find<mp_list<U...>, mp_at_c<mp_list<T...>, I>>;
+
+            return this->_subset_impl<U...>( J{}, this->_get_impl( I ) );
+
+        });
+    }
+
+    template<class... U,
+        class E2 = mp_if<mp_all<std::is_copy_constructible<U>..., mp_contains<mp_list<T...>, U>...>, void> >
+    constexpr variant<U...> subset() &&
+    {
+        return variant2::detail::dispatch_index<sizeof...(T)>( index(), [&]( auto I ){
+
+            using J = mp_find<mp_list<U...>, mp_at_c<mp_list<T...>, I>>;
+
+            return this->_subset_impl<U...>( J{}, std::move( this->_get_impl( I ) ) );
+
+        });
+    }
+
+    template<class... U,
+        class E2 = mp_if<mp_all<std::is_copy_constructible<U>..., mp_contains<mp_list<T...>, U>...>, void> >
+    constexpr variant<U...> subset() const&&
+    {
+        return variant2::detail::dispatch_index<sizeof...(T)>( index(), [&]( auto I ){
+
+            using J = mp_find<mp_list<U...>, mp_at_c<mp_list<T...>, I>>;
+
+            return this->_subset_impl<U...>( J{}, std::move( this->_get_impl( I ) ) );
+
+        });
+    }
+};
+
+// variant_index_layout (extension)
+
+enum class index_layout
+{
+    before_storage,
+    after_storage,
+    in_storage
+};
+
+template<class V> struct variant_index_layout
+{
+};
+
+template<class V> struct variant_index_layout<V const>: variant_index_layout<V>
+{
+};
+
+template<class V> struct variant_index_layout<V volatile>: variant_index_layout<V>
+{
+};
+
+template<class V> struct variant_index_layout<V const volatile>: variant_index_layout<V>
+{
+};
+
+template<class... T> struct variant_index_layout<variant<T...>>: std::integral_constant<index_layout,
+    variant2::detail::is_niche_variant<T...>::value? index_layout::in_storage:
+    variant2::detail::fields_index_after_storage<typename variant2::detail::variant_indexed_base<T...>::fields>::value? index_layout::after_storage: index_layout::before_storage>
+{
+};
+
+// basic_variant (extension)
+//
+// basic_variant<variant_policy::may_be_valueless, T...> holds a variant<valueless, T...>
+// and presents it as having the alternatives T..., with index() == variant_npos
+// when the valueless alternative is active; since the first alternative is
+// valueless, the storage is single and emplace constructs in place, becoming
+// valueless when that throws
+
+namespace detail
+{
+
+template<class P> using basic_variant_offset = mp_size_t<std::is_same<P, variant_policy::may_be_valueless>::value? 1: 0>;
+
+template<class P, class... T> using basic_variant_impl = mp_if<std::is_same<P, variant_policy::may_be_valueless>, variant<valueless, T...>, variant<T...>>;
+
+} // namespace detail
+
+template<class P, class... T> struct variant_size<basic_variant<P, T...>>: mp_size<mp_list<T...>>
+{
+};
+
+template<std::size_t I, class P, class... T> struct variant_alternative<I, basic_variant<P, T...>>: mp_defer<mp_at, mp_list<T...>, mp_size_t<I>>
+{
+};
+
+template<class P, class... T> class basic_variant
+{
+private:
+
+    static_assert( std::is_same<P, variant_policy::never_valueless>::value || std::is_same<P, variant_policy::may_be_valueless>::value, "Unknown variant policy" );
+
+    using impl_type = variant2::detail::basic_variant_impl<P, T...>;
+    using offset = variant2::detail::basic_variant_offset<P>;
+
+    impl_type v_;
+
+public:
+
+    // constructors
+
+    template<class E1 = void, class E2 = mp_if<std::is_default_constructible< mp_first<mp_list<T...>> >, E1>>
+    constexpr basic_variant()
+        noexcept( std::is_nothrow_default_constructible< mp_first<mp_list<T...>> >::value )
+        : v_( in_place_index<offset::value> )
+    {
+    }
+
+    template<class U,
+        class Ud = std::decay_t<U>,
+        class E1 = std::enable_if_t< !std::is_same<Ud, basic_variant>::value && !variant2::detail::is_in_place_index<Ud>::value && !variant2::detail::is_in_place_type<Ud>::value >,
+        class V = variant2::detail::resolve_overload_type<U&&, T...>,
+        class E2 = std::enable_if_t<std::is_constructible<V, U>::value>
+        >
+    constexpr basic_variant( U&& u )
+        noexcept( std::is_nothrow_constructible<V, U>::value )
+        : v_( in_place_index<variant2::detail::resolve_overload_index<U&&, T...>::value + offset::value>, std::forward<U>(u) )
+    {
+    }
+
+    template<class U, class... A, class E = std::enable_if_t<mp_contains<mp_list<T...>, U>::value && std::is_constructible<U, A...>::value>>
+    constexpr explicit basic_variant( in_place_type_t<U>, A&&... a ): v_( in_place_type<U>, std::forward<A>(a)... )
+    {
+    }
+
+    template<class U, class V, class... A, class E = std::enable_if_t<mp_contains<mp_list<T...>, U>::value && std::is_constructible<U, std::initializer_list<V>&, A...>::value>>
+    constexpr explicit basic_variant( in_place_type_t<U>, std::initializer_list<V> il, A&&... a ): v_( in_place_type<U>, il, std::forward<A>(a)... )
+    {
+    }
+
+    template<std::size_t I, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<mp_list<T...>, I>, A...>::value>>
+    constexpr explicit basic_variant( in_place_index_t<I>, A&&... a ): v_( in_place_index<I + offset::value>, std::forward<A>(a)... )
+    {
+    }
+
+    template<std::size_t I, class V, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<mp_list<T...>, I>, std::initializer_list<V>&, A...>::value>>
+    constexpr explicit basic_variant( in_place_index_t<I>, std::initializer_list<V> il, A&&... a ): v_( in_place_index<I + offset::value>, il, std::forward<A>(a)... )
+    {
+    }
+
+    template<class F, class E = std::enable_if_t<std::is_constructible<impl_type, in_place_factory_t, F>::value>>
+    constexpr explicit basic_variant( in_place_factory_t, F&& f ): v_( in_place_factory, std::forward<F>(f) )
+    {
+    }
+
+    // assignment
+
+    template<class U,
+        class E1 = std::enable_if_t<!std::is_same<std::decay_t<U>, basic_variant>::value>,
+        class V = variant2::detail::resolve_overload_type<U, T...>,
+        class E2 = std::enable_if_t<std::is_assignable<V&, U>::value && std::is_constructible<V, U>::value>
+    >
+    constexpr basic_variant& operator=( U&& u )
+        noexcept( std::is_nothrow_assignable<V&, U>::value && std::is_nothrow_constructible<V, U>::value )
+    {
+        std::size_t const I = variant2::detail::resolve_overload_index<U, T...>::value + offset::value;
+
+        if( v_.index() == I )
+        {
+            v_._get_impl( mp_size_t<I>() ) = std::forward<U>(u);
+        }
+        else
+        {
+            v_.template emplace<I>( std::forward<U>(u) );
+        }
+
+        return *this;
+    }
+
+    // modifiers
+
+    template<class U, class... A, class E = std::enable_if_t<mp_contains<mp_list<T...>, U>::value && std::is_constructible<U, A...>::value>>
+    constexpr U& emplace( A&&... a )
+    {
+        return v_.template emplace<U>( std::forward<A>(a)... );
+    }
+
+    template<class U, class V, class... A, class E = std::enable_if_t<mp_contains<mp_list<T...>, U>::value && std::is_constructible<U, std::initializer_list<V>&, A...>::value>>
+    constexpr U& emplace( std::initializer_list<V> il, A&&... a )
+    {
+        return v_.template emplace<U>( il, std::forward<A>(a)... );
+    }
+
+    template<std::size_t I, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<mp_list<T...>, I>, A...>::value>>
+    constexpr mp_at_c<mp_list<T...>, I>& emplace( A&&... a )
+    {
+        return v_.template emplace<I + offset::value>( std::forward<A>(a)... );
+    }
+
+    template<std::size_t I, class V, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<mp_list<T...>, I>, std::initializer_list<V>&, A...>::value>>
+    constexpr mp_at_c<mp_list<T...>, I>& emplace( std::initializer_list<V> il, A&&... a )
+    {
+        return v_.template emplace<I + offset::value>( il, std::forward<A>(a)... );
+    }
+
+    template<class U, class F, class E = std::enable_if_t<mp_contains<mp_list<T...>, U>::value && variant2::detail::is_factory_constructible<U, variant2::detail::factory_result<F>>::value>>
+    constexpr U& emplace_with( F&& f )
+    {
+        return v_.template emplace_with<U>( std::forward<F>(f) );
+    }
+
+    template<std::size_t I, class F, class E = std::enable_if_t<variant2::detail::is_factory_constructible<mp_at_c<mp_list<T...>, I>, variant2::detail::factory_result<F>>::value>>
+    constexpr mp_at_c<mp_list<T...>, I>& emplace_with( F&& f )
+    {
+        return v_.template emplace_with<I + offset::value>( std::forward<F>(f) );
+    }
+
+    // value status
+
+    constexpr bool valueless_by_exception() const noexcept
+    {
+        return offset::value != 0 && v_.index() == 0;
+    }
+
+    constexpr std::size_t index() const noexcept
+    {
+        return valueless_by_exception()? variant_npos: v_.index() - offset::value;
+    }
+
+    // swap
+
+    void swap( basic_variant& r ) noexcept( noexcept( std::declval<impl_type&>().swap( std::declval<impl_type&>() ) ) )
+    {
+        v_.swap( r.v_ );
+    }
+
+    // private accessors
+
+    constexpr impl_type& _impl() noexcept
+    {
+        return v_;
+    }
+
+    constexpr impl_type const& _impl() const noexcept
+    {
+        return v_;
+    }
+
+    template<std::size_t I> constexpr mp_at_c<mp_list<T...>, I>& _get_impl( mp_size_t<I> ) noexcept
+    {
+        return v_._get_impl( mp_size_t<I + offset::value>() );
+    }
+
+    template<std::size_t I> constexpr mp_at_c<mp_list<T...>, I> const& _get_impl( mp_size_t<I> ) const noexcept
+    {
+        return v_._get_impl( mp_size_t<I + offset::value>() );
+    }
+};
+
+// holds_alternative
+
+template<class U, class P, class... T> constexpr bool holds_alternative( basic_variant<P, T...> const& v ) noexcept
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    return v.index() == mp_find<mp_list<T...>, U>::value;
+}
+
+// get (index)
+
+template<std::size_t I, class P, class... T> constexpr variant_alternative_t<I, basic_variant<P, T...>>& get( basic_variant<P, T...>& v )
+{
+    static_assert( I < sizeof...(T), "Index out of bounds" );
+    return get<I + variant2::detail::basic_variant_offset<P>::value>( v._impl() );
+}
+
+template<std::size_t I, class P, class... T> constexpr variant_alternative_t<I, basic_variant<P, T...>>&& get( basic_variant<P, T...>&& v )
+{
+    static_assert( I < sizeof...(T), "Index out of bounds" );
+    return get<I + variant2::detail::basic_variant_offset<P>::value>( std::move( v._impl() ) );
+}
+
+template<std::size_t I, class P, class... T> constexpr variant_alternative_t<I, basic_variant<P, T...>> const& get( basic_variant<P, T...> const& v )
+{
+    static_assert( I < sizeof...(T), "Index out of bounds" );
+    return get<I + variant2::detail::basic_variant_offset<P>::value>( v._impl() );
+}
+
+template<std::size_t I, class P, class... T> constexpr variant_alternative_t<I, basic_variant<P, T...>> const&& get( basic_variant<P, T...> const&& v )
+{
+    static_assert( I < sizeof...(T), "Index out of bounds" );
+    return get<I + variant2::detail::basic_variant_offset<P>::value>( std::move( v._impl() ) );
+}
+
+// get (type)
+
+template<class U, class P, class... T> constexpr U& get( basic_variant<P, T...>& v )
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    return get<U>( v._impl() );
+}
+
+template<class U, class P, class... T> constexpr U&& get( basic_variant<P, T...>&& v )
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    return get<U>( std::move( v._impl() ) );
+}
+
+template<class U, class P, class... T> constexpr U const& get( basic_variant<P, T...> const& v )
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    return get<U>( v._impl() );
+}
+
+template<class U, class P, class... T> constexpr U const&& get( basic_variant<P, T...> const&& v )
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    return get<U>( std::move( v._impl() ) );
+}
+
+// get_if
+
+template<std::size_t I, class P, class... T> constexpr std::add_pointer_t<variant_alternative_t<I, basic_variant<P, T...>>> get_if( basic_variant<P, T...>* v ) noexcept
+{
+    static_assert( I < sizeof...(T), "Index out of bounds" );
+    return v? get_if<I + variant2::detail::basic_variant_offset<P>::value>( &v->_impl() ): 0;
+}
+
+template<std::size_t I, class P, class... T> constexpr std::add_pointer_t<const variant_alternative_t<I, basic_variant<P, T...>>> get_if( basic_variant<P, T...> const * v ) noexcept
+{
+    static_assert( I < sizeof...(T), "Index out of bounds" );
+    return v? get_if<I + variant2::detail::basic_variant_offset<P>::value>( &v->_impl() ): 0;
+}
+
+template<class U, class P, class... T> constexpr std::add_pointer_t<U> get_if( basic_variant<P, T...>* v ) noexcept
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    return v? get_if<U>( &v->_impl() ): 0;
+}
+
+template<class U, class P, class... T> constexpr std::add_pointer_t<U const> get_if( basic_variant<P, T...> const * v ) noexcept
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    return v? get_if<U>( &v->_impl() ): 0;
+}
+
+// relational operators
+//
+// valueless compares equal to valueless and less than any value, as
+// the valueless alternative of the underlying variant does
+
+template<class P, class... T> constexpr bool operator==( basic_variant<P, T...> const & v, basic_variant<P, T...> const & w )
+{
+    return v._impl() == w._impl();
+}
+
+template<class P, class... T> constexpr bool operator!=( basic_variant<P, T...> const & v, basic_variant<P, T...> const & w )
+{
+    return v._impl() != w._impl();
+}
+
+template<class P, class... T> constexpr bool operator<( basic_variant<P, T...> const & v, basic_variant<P, T...> const & w )
+{
+    return v._impl() < w._impl();
+}
+
+template<class P, class... T> constexpr bool operator>( basic_variant<P, T...> const & v, basic_variant<P, T...> const & w )
+{
+    return v._impl() > w._impl();
+}
+
+template<class P, class... T> constexpr bool operator<=( basic_variant<P, T...> const & v, basic_variant<P, T...> const & w )
+{
+    return v._impl() <= w._impl();
+}
+
+template<class P, class... T> constexpr bool operator>=( basic_variant<P, T...> const & v, basic_variant<P, T...> const & w )
+{
+    return v._impl() >= w._impl();
+}
+
+// relational operators
+namespace detail
+{
+
+// bitwise equality
+
+template<class... T> constexpr bool variant_eq( variant<T...> const & v, variant<T...> const & w, mp_false )
+{
+    if( v.index() != w.index() ) return false;
+
+    return dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+        return v._get_impl( I ) == w._get_impl( I );
+
+    });
+}
+
+template<class... T> constexpr bool variant_ne( variant<T...> const & v, variant<T...> const & w, mp_false )
+{
+    if( v.index() != w.index() ) return true;
+
+    return dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+        return v._get_impl( I ) != w._get_impl( I );
+
+    });
+}
+
+#if defined(BOOST_VARIANT2_IS_CONSTANT_EVALUATED)
+
+template<class... T> using is_bitwise_comparable_variant = mp_bool<mp_all<is_bitwise_comparable<T>...>::value && is_single_buffered<T...>::value && !is_niche_variant<T...>::value>;
+
+template<class... T> constexpr bool variant_eq( variant<T...> const & v, variant<T...> const & w, mp_true )
+{
+    if( BOOST_VARIANT2_IS_CONSTANT_EVALUATED() ) return variant_eq( v, w, mp_false() );
+
+    return v.index() == w.index() && std::memcmp( v._storage(), w._storage(), alternative_sizes<T...>::value[ v.index() ] ) == 0;
+}
+
+template<class... T> constexpr bool variant_ne( variant<T...> const & v, variant<T...> const & w, mp_true )
+{
+    return !variant_eq( v, w, mp_true() );
+}
+
+#else
+
+// memcmp can't be used in constant evaluation, which can't be detected here
+
+template<class... T> using is_bitwise_comparable_variant = mp_false;
+
+#endif
+
+} // namespace detail
+
+template<class... T> constexpr bool operator==( variant<T...> const & v, variant<T...> const & w )
+{
+    return variant2::detail::variant_eq( v, w, variant2::detail::is_bitwise_comparable_variant<T...>() );
+}
+
+template<class... T> constexpr bool operator!=( variant<T...> const & v, variant<T...> const & w )
+{
+    return variant2::detail::variant_ne( v, w, variant2::detail::is_bitwise_comparable_variant<T...>() );
+}
+
+template<class... T> constexpr bool operator<( variant<T...> const & v, variant<T...> const & w )
+{
+    if( v.index() < w.index() ) return true;
+    if( v.index() > w.index() ) return false;
+
+    return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+        return v._get_impl( I ) < w._get_impl( I );
+
+    });
+}
+
+template<class... T> constexpr bool operator>(  variant<T...> const & v, variant<T...> const & w )
+{
+    if( v.index() > w.index() ) return true;
+    if( v.index() < w.index() ) return false;
+
+    return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+        return v._get_impl( I ) > w._get_impl( I );
+
+    });
+}
+
+template<class... T> constexpr bool operator<=( variant<T...> const & v, variant<T...> const & w )
+{
+    if( v.index() < w.index() ) return true;
+    if( v.index() > w.index() ) return false;
+
+    return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+        return v._get_impl( I ) <= w._get_impl( I );
+
+    });
+}
+
+template<class... T> constexpr bool operator>=( variant<T...> const & v, variant<T...> const & w )
+{
+    if( v.index() > w.index() ) return true;
+    if( v.index() < w.index() ) return false;
+
+    return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+        return v._get_impl( I ) >= w._get_impl( I );
+
+    });
+}
+
+// compare (extension)
+//
+// Returns a negative value, zero, or a positive value when v is less than,
+// equivalent to, or greater than w, with a single comparison of the indices
+// and a single dispatch. Alternatives are compared with their three-way
+// comparison when they have one, and with < otherwise
+
+namespace detail
+{
+
+#if defined( BOOST_VARIANT2_HAS_THREE_WAY_COMPARISON )
+
+template<class T> using three_way_result = decltype( std::declval<T const&>() <=> std::declval<T const&>() );
+template<class T> using has_three_way = mp_valid<three_way_result, T>;
+
+template<class T> constexpr int compare_alternative( T const& a, T const& b, mp_true )
+{
+    auto r = a <=> b;
+    return ( r > 0 ) - ( r < 0 );
+}
+
+#else
+
+template<class T> using has_three_way = mp_false;
+
+#endif
+
+template<class T> constexpr int compare_alternative( T const& a, T const& b, mp_false )
+{
+    return a < b? -1: ( b < a? 1: 0 );
+}
+
+} // namespace detail
+
+template<class... T> constexpr int compare( variant<T...> const & v, variant<T...> const & w )
+{
+    if( v.index() != w.index() ) return v.index() < w.index()? -1: 1;
+
+    return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+        using U = mp_at_c<mp_list<T...>, I>;
+        return variant2::detail::compare_alternative( v._get_impl( I ), w._get_impl( I ), variant2::detail::has_three_way<U>() );
+
+    });
+}
+
+template<class P, class... T> constexpr int compare( basic_variant<P, T...> const & v, basic_variant<P, T...> const & w )
+{
+    return compare( v._impl(), w._impl() );
+}
+
+// compare_less (extension)
+//
+// A function object that orders variants by compare, for std::sort and
+// ordered containers
+
+struct compare_less
+{
+    template<class V> constexpr bool operator()( V const & v, V const & w ) const
+    {
+        return compare( v, w ) < 0;
+    }
+};
+
+#if defined( BOOST_VARIANT2_HAS_THREE_WAY_COMPARISON )
+
+// operator<=>
+
+template<class... T> requires ( std::three_way_comparable<T> && ... )
+constexpr std::common_comparison_category_t<std::compare_three_way_result_t<T>...> operator<=>( variant<T...> const & v, variant<T...> const & w )
+{
+    using R = std::common_comparison_category_t<std::compare_three_way_result_t<T>...>;
+
+    if( v.index() != w.index() ) return v.index() <=> w.index();
+
+    return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ) -> R {
+
+        return v._get_impl( I ) <=> w._get_impl( I );
+
+    });
+}
+
+template<class P, class... T> requires ( std::three_way_comparable<T> && ... )
+constexpr std::common_comparison_category_t<std::compare_three_way_result_t<T>...> operator<=>( basic_variant<P, T...> const & v, basic_variant<P, T...> const & w )
+{
+    using R = std::common_comparison_category_t<std::compare_three_way_result_t<T>...>;
+
+    // valueless is less than any value, as for compare
+
+    if( v.valueless_by_exception() || w.valueless_by_exception() ) return w.valueless_by_exception() <=> v.valueless_by_exception();
+    if( v.index() != w.index() ) return v.index() <=> w.index();
+
+    return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ) -> R {
+
+        return get<I>( v ) <=> get<I>( w );
+
+    });
+}
+
+#endif
+
+// visitation
+namespace detail
+{
+
+template<class F> struct Qret
+{
+    template<class... T> using fn = decltype( std::declval<F>()( std::declval<T>()... ) );
+};
+
+template<class L> using front_if_same = mp_if<mp_apply<mp_same, L>, mp_front<L>>;
+
+template<class V> using var_size = variant_size<std::remove_reference_t<V>>;
+
+template<class V, class I> using var_alternative = variant_alternative_t<I::value, std::remove_cv_t<std::remove_reference_t<V>>>;
+
+#if BOOST_WORKAROUND( BOOST_MSVC, <= 1910 )
+
+template<class V> struct var_alternatives_impl
+{
+    template<class I> using _f = var_alternative<V, I>;
+
+    using type = mp_transform<_f, mp_iota<var_size<V>>>;
+};
+
+template<class V> using var_alternatives = typename var_alternatives_impl<V>::type;
+
+#else
+
+template<class V> using var_alternatives = mp_transform_q<mp_bind_front<var_alternative, V>, mp_iota<var_size<V>>>;
+
+#endif
+
+// visit_get
+//
+// get<I>( v ), without the index check for variant, as visit has already
+// dispatched on the index
+
+template<std::size_t I, class V> constexpr decltype(auto) visit_get( V&& v )
+{
+    return get<I>( std::forward<V>(v) );
+}
+
+template<std::size_t I, class... T> constexpr variant_alternative_t<I, variant<T...>>& visit_get( variant<T...>& v ) noexcept
+{
+    return v._get_impl( mp_size_t<I>() );
+}
+
+template<std::size_t I, class... T> constexpr variant_alternative_t<I, variant<T...>>&& visit_get( variant<T...>&& v ) noexcept
+{
+    return std::move( v._get_impl( mp_size_t<I>() ) );
+}
+
+template<std::size_t I, class... T> constexpr variant_alternative_t<I, variant<T...>> const& visit_get( variant<T...> const& v ) noexcept
+{
+    return v._get_impl( mp_size_t<I>() );
+}
+
+template<std::size_t I, class... T> constexpr variant_alternative_t<I, variant<T...>> const&& visit_get( variant<T...> const&& v ) noexcept
+{
+    return std::move( v._get_impl( mp_size_t<I>() ) );
+}
+
+// the type visit passes to f for the alternative N of V
+
+template<class V, class N> using apply_cv_ref_ = decltype( visit_get<N::value>( std::declval<V>() ) );
+
+#if BOOST_WORKAROUND( BOOST_MSVC, <= 1910 )
+
+template<class V> struct apply_cv_ref_impl
+{
+    template<class T> using _f = apply_cv_ref_<V, T>;
+
+    using L = mp_iota<var_size<V>>;
+
+    using type = mp_transform<_f, L>;
+};
+
+template<class V> using apply_cv_ref = typename apply_cv_ref_impl<V>::type;
+
+#else
+
+template<class V> using apply_cv_ref = mp_transform_q<mp_bind_front<apply_cv_ref_, V>, mp_iota<var_size<V>>>;
+
+#endif
+
+template<class F, class... V> using Vret = front_if_same<mp_product_q<Qret<F>, apply_cv_ref<V>...>>;
+
+// visit_index
+//
+// index() of the visited variant, throwing bad_variant_access when it's valueless
+
+template<class V> constexpr std::size_t visit_index( V const& v ) noexcept
+{
+    return v.index();
+}
+
+template<class P, class... T> constexpr std::size_t visit_index( basic_variant<P, T...> const& v )
+{
+#if BOOST_WORKAROUND( BOOST_GCC, < 60000 )
+
+    return (void)( v.valueless_by_exception()? throw bad_variant_access(): 0 ), v.index();
+
+#else
+
+    if( v.valueless_by_exception() ) throw bad_variant_access();
+    return v.index();
+
+#endif
 }
 
-template<class... T> constexpr bool operator<( variant<T...> const & v, variant<T...> const & w )
-{
-    if( v.index() < w.index() ) return true;
-    if( v.index() > w.index() ) return false;
+// visit_impl
 
-    return mp_with_index<sizeof...(T)>( v.index(), [&]( auto I ){
+template<class D, class F, class V1> constexpr auto visit_impl( F&& f, V1&& v1 ) -> Vret<F, V1>
+{
+    return dispatch_alternative<var_alternatives<V1>, D>( visit_index( v1 ), [&]( auto I ){
 
-        return v._get_impl( I ) < w._get_impl( I );
+        return std::forward<F>(f)( visit_get<I>( std::forward<V1>(v1) ) );
 
     });
 }
 
-template<class... T> constexpr bool operator>(  variant<T...> const & v, variant<T...> const & w )
+#if !BOOST_WORKAROUND( BOOST_MSVC, <= 1910 )
+
+// flattened multi-visitation
+//
+// The indices of v1, v2, ..., vn are combined into i1 * N2 * ... * Nn + ... + in,
+// which is dispatched on once
+
+template<class... V> constexpr std::size_t visit_flat_size()
 {
-    if( v.index() > w.index() ) return true;
-    if( v.index() < w.index() ) return false;
+    std::size_t const n[] = { var_size<V>::value... };
 
-    return mp_with_index<sizeof...(T)>( v.index(), [&]( auto I ){
+    std::size_t r = 1;
 
-        return v._get_impl( I ) > w._get_impl( I );
+    for( std::size_t i = 0; i < sizeof...(V); ++i )
+    {
+        if( r > static_cast<std::size_t>( -1 ) / n[ i ] ) return static_cast<std::size_t>( -1 );
+        r *= n[ i ];
+    }
 
-    });
+    return r;
 }
 
-template<class... T> constexpr bool operator<=( variant<T...> const & v, variant<T...> const & w )
+template<class... V> constexpr std::size_t visit_flat_stride( std::size_t j )
 {
-    if( v.index() < w.index() ) return true;
-    if( v.index() > w.index() ) return false;
+    std::size_t const n[] = { var_size<V>::value... };
 
-    return mp_with_index<sizeof...(T)>( v.index(), [&]( auto I ){
+    std::size_t r = 1;
 
-        return v._get_impl( I ) <= w._get_impl( I );
+    for( std::size_t i = j + 1; i < sizeof...(V); ++i )
+    {
+        r *= n[ i ];
+    }
 
-    });
+    return r;
 }
 
-template<class... T> constexpr bool operator>=( variant<T...> const & v, variant<T...> const & w )
+template<class... V> constexpr std::size_t visit_flat_index( V const&... v )
 {
-    if( v.index() > w.index() ) return true;
-    if( v.index() < w.index() ) return false;
+    std::size_t const n[] = { var_size<V>::value... };
+    std::size_t const k[] = { visit_index( v )... };
 
-    return mp_with_index<sizeof...(T)>( v.index(), [&]( auto I ){
+    std::size_t r = 0;
 
-        return v._get_impl( I ) >= w._get_impl( I );
+    for( std::size_t i = 0; i < sizeof...(V); ++i )
+    {
+        r = r * n[ i ] + k[ i ];
+    }
 
-    });
+    return r;
 }
 
-// visitation
-namespace detail
-{
-
-template<class F> struct Qret
+template<std::size_t K, std::size_t... J, class F, class... V> constexpr decltype(auto) visit_flat_call( mp_size_t<K>, std::index_sequence<J...>, F&& f, V&&... v )
 {
-    template<class... T> using fn = decltype( std::declval<F>()( std::declval<T>()... ) );
-};
+    return std::forward<F>(f)( visit_get<( K / visit_flat_stride<V...>( J ) ) % var_size<V>::value>( std::forward<V>(v) )... );
+}
 
-template<class L> using front_if_same = mp_if<mp_apply<mp_same, L>, mp_front<L>>;
+template<class D, class F, class V1, class V2, class... V> constexpr auto visit_impl( F&& f, V1&& v1, V2&& v2, V&&... v ) -> Vret<F, V1, V2, V...>;
 
-template<class V> using var_size = variant_size<std::remove_reference_t<V>>;
+template<class... V> using visit_flat_cold = mp_product<mp_or, mp_transform<is_cold, var_alternatives<V>>...>;
 
-template<class V, class N, class T = variant_alternative_t<N::value, std::remove_reference_t<V>>> using apply_cv_ref_ = mp_if<std::is_reference<V>, T&, T>;
+template<class D, class F, class... V> constexpr auto visit_multi( mp_true, F&& f, V&&... v ) -> Vret<F, V...>
+{
+    return dispatch_index_cold<visit_flat_cold<V...>, D>( visit_flat_index( v... ), [&]( auto K ){
 
-#if BOOST_WORKAROUND( BOOST_MSVC, <= 1910 )
+        return visit_flat_call( K, std::index_sequence_for<V...>(), std::forward<F>(f), std::forward<V>(v)... );
 
-template<class V> struct apply_cv_ref_impl
-{
-    template<class T> using _f = apply_cv_ref_<V, T>;
+    });
+}
 
-    using L = mp_iota<var_size<V>>;
+// too many combinations, dispatch on v1 and visit the rest
 
-    using type = mp_transform<_f, L>;
-};
+template<class D, class F, class V1, class... V> constexpr auto visit_multi( mp_false, F&& f, V1&& v1, V&&... v ) -> Vret<F, V1, V...>
+{
+    return dispatch_alternative<var_alternatives<V1>, D>( visit_index( v1 ), [&]( auto I ){
 
-template<class V> using apply_cv_ref = typename apply_cv_ref_impl<V>::type;
+        auto f2 = [&]( auto&&... a ){ return std::forward<F>(f)( visit_get<I.value>( std::forward<V1>(v1) ), std::forward<decltype(a)>(a)... ); };
+        return visit_impl<D>( f2, std::forward<V>(v)... );
 
-#else
+    });
+}
 
-template<class V> using apply_cv_ref = mp_transform_q<mp_bind_front<apply_cv_ref_, V>, mp_iota<var_size<V>>>;
+template<class D, class F, class V1, class V2, class... V> constexpr auto visit_impl( F&& f, V1&& v1, V2&& v2, V&&... v ) -> Vret<F, V1, V2, V...>
+{
+    using flat = mp_bool<( visit_flat_size<V1, V2, V...>() <= BOOST_VARIANT2_MAX_FLAT_VISIT )>;
+    return visit_multi<D>( flat(), std::forward<F>(f), std::forward<V1>(v1), std::forward<V2>(v2), std::forward<V>(v)... );
+}
 
 #endif
 
-template<class F, class... V> using Vret = front_if_same<mp_product_q<Qret<F>, apply_cv_ref<V>...>>;
-
 } // namespace detail
 
 template<class F> constexpr auto visit( F&& f ) -> decltype(std::forward<F>(f)())
@@ -1351,18 +3118,14 @@ template<class F> constexpr auto visit( F&& f ) -> decltype(std::forward<F>(f)()
 
 template<class F, class V1> constexpr auto visit( F&& f, V1&& v1 ) -> variant2::detail::Vret<F, V1>
 {
-    return mp_with_index<variant2::detail::var_size<V1>>( v1.index(), [&]( auto I ){
-
-        return std::forward<F>(f)( get<I>( std::forward<V1>(v1) ) );
-
-    });
+    return variant2::detail::visit_impl<dispatch::default_dispatch>( std::forward<F>(f), std::forward<V1>(v1) );
 }
 
 #if BOOST_WORKAROUND( BOOST_MSVC, <= 1910 )
 
 template<class F, class V1, class V2> constexpr auto visit( F&& f, V1&& v1, V2&& v2 ) -> variant2::detail::Vret<F, V1, V2>
 {
-    return mp_with_index<variant2::detail::var_size<V1>>( v1.index(), [&]( auto I ){
+    return variant2::detail::dispatch_index<variant2::detail::var_size<V1>::value>( variant2::detail::visit_index( v1 ), [&]( auto I ){
 
         auto f2 = [&]( auto&&... a ){ return std::forward<F>(f)( get<I.value>( std::forward<V1>(v1) ), std::forward<decltype(a)>(a)... ); };
         return visit( f2, std::forward<V2>(v2) );
@@ -1372,7 +3135,7 @@ template<class F, class V1, class V2> constexpr auto visit( F&& f, V1&& v1, V2&&
 
 template<class F, class V1, class V2, class V3> constexpr auto visit( F&& f, V1&& v1, V2&& v2, V3&& v3 ) -> variant2::detail::Vret<F, V1, V2, V3>
 {
-    return mp_with_index<variant2::detail::var_size<V1>>( v1.index(), [&]( auto I ){
+    return variant2::detail::dispatch_index<variant2::detail::var_size<V1>::value>( variant2::detail::visit_index( v1 ), [&]( auto I ){
 
         auto f2 = [&]( auto&&... a ){ return std::forward<F>(f)( get<I.value>( std::forward<V1>(v1) ), std::forward<decltype(a)>(a)... ); };
         return visit( f2, std::forward<V2>(v2), std::forward<V3>(v3) );
@@ -1382,7 +3145,7 @@ template<class F, class V1, class V2, class V3> constexpr auto visit( F&& f, V1&
 
 template<class F, class V1, class V2, class V3, class V4> constexpr auto visit( F&& f, V1&& v1, V2&& v2, V3&& v3, V4&& v4 ) -> variant2::detail::Vret<F, V1, V2, V3, V4>
 {
-    return mp_with_index<variant2::detail::var_size<V1>>( v1.index(), [&]( auto I ){
+    return variant2::detail::dispatch_index<variant2::detail::var_size<V1>::value>( variant2::detail::visit_index( v1 ), [&]( auto I ){
 
         auto f2 = [&]( auto&&... a ){ return std::forward<F>(f)( get<I.value>( std::forward<V1>(v1) ), std::forward<decltype(a)>(a)... ); };
         return visit( f2, std::forward<V2>(v2), std::forward<V3>(v3), std::forward<V4>(v4) );
@@ -1394,16 +3157,99 @@ template<class F, class V1, class V2, class V3, class V4> constexpr auto visit(
 
 template<class F, class V1, class V2, class... V> constexpr auto visit( F&& f, V1&& v1, V2&& v2, V&&... v ) -> variant2::detail::Vret<F, V1, V2, V...>
 {
-    return mp_with_index<variant2::detail::var_size<V1>>( v1.index(), [&]( auto I ){
+    return variant2::detail::visit_impl<dispatch::default_dispatch>( std::forward<F>(f), std::forward<V1>(v1), std::forward<V2>(v2), std::forward<V>(v)... );
+}
+
+#endif
+
+// visit<D>, with an explicit dispatch policy
+
+template<class D, class F, class V1, class E = std::enable_if_t<dispatch::is_dispatch<D>::value>> constexpr auto visit( F&& f, V1&& v1 ) -> variant2::detail::Vret<F, V1>
+{
+    return variant2::detail::visit_impl<D>( std::forward<F>(f), std::forward<V1>(v1) );
+}
+
+#if BOOST_WORKAROUND( BOOST_MSVC, <= 1910 )
+
+template<class D, class F, class V1, class V2, class E = std::enable_if_t<dispatch::is_dispatch<D>::value>> constexpr auto visit( F&& f, V1&& v1, V2&& v2 ) -> variant2::detail::Vret<F, V1, V2>
+{
+    return variant2::detail::dispatch_index<variant2::detail::var_size<V1>::value, D>( variant2::detail::visit_index( v1 ), [&]( auto I ){
+
+        auto f2 = [&]( auto&&... a ){ return std::forward<F>(f)( get<I.value>( std::forward<V1>(v1) ), std::forward<decltype(a)>(a)... ); };
+        return visit<D>( f2, std::forward<V2>(v2) );
+
+    });
+}
+
+template<class D, class F, class V1, class V2, class V3, class E = std::enable_if_t<dispatch::is_dispatch<D>::value>> constexpr auto visit( F&& f, V1&& v1, V2&& v2, V3&& v3 ) -> variant2::detail::Vret<F, V1, V2, V3>
+{
+    return variant2::detail::dispatch_index<variant2::detail::var_size<V1>::value, D>( variant2::detail::visit_index( v1 ), [&]( auto I ){
+
+        auto f2 = [&]( auto&&... a ){ return std::forward<F>(f)( get<I.value>( std::forward<V1>(v1) ), std::forward<decltype(a)>(a)... ); };
+        return visit<D>( f2, std::forward<V2>(v2), std::forward<V3>(v3) );
+
+    });
+}
+
+template<class D, class F, class V1, class V2, class V3, class V4, class E = std::enable_if_t<dispatch::is_dispatch<D>::value>> constexpr auto visit( F&& f, V1&& v1, V2&& v2, V3&& v3, V4&& v4 ) -> variant2::detail::Vret<F, V1, V2, V3, V4>
+{
+    return variant2::detail::dispatch_index<variant2::detail::var_size<V1>::value, D>( variant2::detail::visit_index( v1 ), [&]( auto I ){
 
         auto f2 = [&]( auto&&... a ){ return std::forward<F>(f)( get<I.value>( std::forward<V1>(v1) ), std::forward<decltype(a)>(a)... ); };
-        return visit( f2, std::forward<V2>(v2), std::forward<V>(v)... );
+        return visit<D>( f2, std::forward<V2>(v2), std::forward<V3>(v3), std::forward<V4>(v4) );
 
     });
 }
 
+#else
+
+template<class D, class F, class V1, class V2, class... V, class E = std::enable_if_t<dispatch::is_dispatch<D>::value>> constexpr auto visit( F&& f, V1&& v1, V2&& v2, V&&... v ) -> variant2::detail::Vret<F, V1, V2, V...>
+{
+    return variant2::detail::visit_impl<D>( std::forward<F>(f), std::forward<V1>(v1), std::forward<V2>(v2), std::forward<V>(v)... );
+}
+
 #endif
 
+// visit_likely
+//
+// visit_likely<I...>( f, v ) and visit_likely<T...>( f, v ) test for the
+// hinted alternatives inline, in order, and leave the others to an out of
+// line visit
+
+namespace detail
+{
+
+template<class F, class V> BOOST_NOINLINE BOOST_VARIANT2_COLD constexpr auto visit_unlikely( F&& f, V&& v ) -> Vret<F, V>
+{
+    return visit_impl<dispatch::default_dispatch>( std::forward<F>(f), std::forward<V>(v) );
+}
+
+template<class F, class V> constexpr auto visit_likely_impl( mp_list<>, F&& f, V&& v ) -> Vret<F, V>
+{
+    return visit_unlikely( std::forward<F>(f), std::forward<V>(v) );
+}
+
+template<class I, class... J, class F, class V> constexpr auto visit_likely_impl( mp_list<I, J...>, F&& f, V&& v ) -> Vret<F, V>
+{
+    return BOOST_LIKELY( v.index() == I::value )? std::forward<F>(f)( visit_get<I::value>( std::forward<V>(v) ) ): visit_likely_impl( mp_list<J...>(), std::forward<F>(f), std::forward<V>(v) );
+}
+
+template<class V, class T> using var_find = mp_find<var_alternatives<V>, T>;
+
+} // namespace detail
+
+template<std::size_t I, std::size_t... J, class F, class V> constexpr auto visit_likely( F&& f, V&& v ) -> variant2::detail::Vret<F, V>
+{
+    static_assert( mp_all<mp_bool<( I < variant2::detail::var_size<V>::value )>, mp_bool<( J < variant2::detail::var_size<V>::value )>...>::value, "Index out of bounds" );
+    return variant2::detail::visit_likely_impl( mp_list<mp_size_t<I>, mp_size_t<J>...>(), std::forward<F>(f), std::forward<V>(v) );
+}
+
+template<class T, class... U, class F, class V> constexpr auto visit_likely( F&& f, V&& v ) -> variant2::detail::Vret<F, V>
+{
+    static_assert( mp_all<mp_bool<mp_count<variant2::detail::var_alternatives<V>, T>::value == 1>, mp_bool<mp_count<variant2::detail::var_alternatives<V>, U>::value == 1>...>::value, "The type must occur exactly once in the list of variant alternatives" );
+    return variant2::detail::visit_likely_impl( mp_list<variant2::detail::var_find<V, T>, variant2::detail::var_find<V, U>...>(), std::forward<F>(f), std::forward<V>(v) );
+}
+
 // specialized algorithms
 template<class... T,
     class E = std::enable_if_t<mp_all<std::is_move_constructible<T>..., variant2::detail::is_swappable<T>...>::value>>
@@ -1413,7 +3259,236 @@ void swap( variant<T...> & v, variant<T...> & w )
     v.swap( w );
 }
 
+template<class P, class... T,
+    class E = std::enable_if_t<mp_all<std::is_move_constructible<T>..., variant2::detail::is_swappable<T>...>::value>>
+void swap( basic_variant<P, T...> & v, basic_variant<P, T...> & w )
+    noexcept( noexcept(v.swap(w)) )
+{
+    v.swap( w );
+}
+
+// hash_value (extension)
+//
+// Mixes the index with the std::hash of the held alternative, after a
+// single dispatch on the index
+
+namespace detail
+{
+
+inline std::size_t hash_mix( std::size_t h, std::size_t k ) noexcept
+{
+    return h ^ ( k + 0x9e3779b9 + ( h << 6 ) + ( h >> 2 ) );
+}
+
+template<class T> std::size_t hash_alternative( T const& t )
+{
+    return std::hash<T>()( t );
+}
+
+inline std::size_t hash_alternative( valueless ) noexcept
+{
+    return 0;
+}
+
+} // namespace detail
+
+template<class... T> std::size_t hash_value( variant<T...> const & v )
+{
+    return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+        return variant2::detail::hash_mix( I, variant2::detail::hash_alternative( v._get_impl( I ) ) );
+
+    });
+}
+
+template<class P, class... T> std::size_t hash_value( basic_variant<P, T...> const & v )
+{
+    return hash_value( v._impl() );
+}
+
+// hash_base
+//
+// The base of the std::hash specializations. When E is mp_false, because
+// std::hash isn't enabled for every alternative, it's disabled like
+// std::hash<U> for an unhashable U
+
+namespace detail
+{
+
+template<class T> using hash_result = decltype( std::hash<T>()( std::declval<T const&>() ) );
+
+template<class... T> using is_hash_enabled = mp_all<mp_valid<hash_result, std::remove_const_t<T>>...>;
+
+template<class V, class E> struct hash_base
+{
+    std::size_t operator()( V const & v ) const
+    {
+        return hash_value( v );
+    }
+};
+
+template<class V> struct hash_base<V, mp_false>
+{
+    hash_base() = delete;
+    hash_base( hash_base const& ) = delete;
+    hash_base& operator=( hash_base const& ) = delete;
+
+    std::size_t operator()( V const & ) const = delete;
+};
+
+} // namespace detail
+
+// relocate_at (extension)
+//
+// Moves *p into the uninitialized storage at q and destroys *p, copying
+// the bytes when T is trivially relocatable
+
+namespace detail
+{
+
+template<class T> T* relocate_at_impl( T* p, T* q, mp_true ) noexcept
+{
+    std::memcpy( static_cast<void*>( q ), static_cast<void const*>( p ), sizeof( T ) );
+    return q;
+}
+
+template<class T> T* relocate_at_impl( T* p, T* q, mp_false ) noexcept( std::is_nothrow_move_constructible<T>::value )
+{
+    ::new( static_cast<void*>( q ) ) T( std::move( *p ) );
+    p->~T();
+
+    return q;
+}
+
+} // namespace detail
+
+template<class T> T* relocate_at( T* p, T* q ) noexcept( is_trivially_relocatable<T>::value || std::is_nothrow_move_constructible<T>::value )
+{
+    return variant2::detail::relocate_at_impl( p, q, is_trivially_relocatable<T>() );
+}
+
+// uninitialized_relocate (extension)
+//
+// Relocates [first, last) into the uninitialized storage at d_first, with a
+// single memcpy when T is trivially relocatable; returns the end of the
+// destination range. If a move constructor throws, the objects constructed
+// in the destination so far are destroyed, and the source objects already
+// moved from are left in their moved-from state; none of them is destroyed.
+
+namespace detail
+{
+
+template<class T> T* uninitialized_relocate_impl( T* first, T* last, T* d_first, mp_true ) noexcept
+{
+    std::size_t const n = last - first;
+
+    if( n != 0 )
+    {
+        std::memmove( static_cast<void*>( d_first ), static_cast<void const*>( first ), n * sizeof( T ) );
+    }
+
+    return d_first + n;
+}
+
+template<class T> T* uninitialized_relocate_impl( T* first, T* last, T* d_first, mp_false )
+{
+    T* d = d_first;
+
+    try
+    {
+        for( T* p = first; p != last; ++p, ++d )
+        {
+            ::new( static_cast<void*>( d ) ) T( std::move( *p ) );
+        }
+    }
+    catch( ... )
+    {
+        while( d != d_first )
+        {
+            (--d)->~T();
+        }
+
+        throw;
+    }
+
+    for( T* p = first; p != last; ++p )
+    {
+        p->~T();
+    }
+
+    return d;
+}
+
+} // namespace detail
+
+template<class T> T* uninitialized_relocate( T* first, T* last, T* d_first ) noexcept( is_trivially_relocatable<T>::value || std::is_nothrow_move_constructible<T>::value )
+{
+    return variant2::detail::uninitialized_relocate_impl( first, last, d_first, is_trivially_relocatable<T>() );
+}
+
+// alternative_value (extension)
+//
+// Returned by get_if for variants that don't store their alternatives as
+// objects, such as ptr_variant; holds a copy of the alternative when it's
+// the one held, nothing otherwise, and is used as a pointer to it
+
+template<class T> class alternative_value
+{
+private:
+
+    T v_;
+    bool has_value_;
+
+public:
+
+    constexpr alternative_value() noexcept: v_(), has_value_( false )
+    {
+    }
+
+    constexpr explicit alternative_value( T const& v ) noexcept: v_( v ), has_value_( true )
+    {
+    }
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return has_value_;
+    }
+
+    constexpr T const& operator*() const noexcept
+    {
+        return v_;
+    }
+
+    constexpr T const* operator->() const noexcept
+    {
+        return &v_;
+    }
+};
+
 } // namespace variant2
 } // namespace boost
 
+// std::hash
+
+namespace std
+{
+
+template<> struct hash<::boost::variant2::monostate>
+{
+    std::size_t operator()( ::boost::variant2::monostate ) const noexcept
+    {
+        return 0;
+    }
+};
+
+template<class... T> struct hash<::boost::variant2::variant<T...>>: ::boost::variant2::detail::hash_base<::boost::variant2::variant<T...>, ::boost::variant2::detail::is_hash_enabled<T...>>
+{
+};
+
+template<class P, class... T> struct hash<::boost::variant2::basic_variant<P, T...>>: ::boost::variant2::detail::hash_base<::boost::variant2::basic_variant<P, T...>, ::boost::variant2::detail::is_hash_enabled<T...>>
+{
+};
+
+} // namespace std
+
 #endif // #ifndef BOOST_VARIANT2_VARIANT_HPP_INCLUDED
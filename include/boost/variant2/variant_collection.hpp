@@ -0,0 +1,221 @@
+#ifndef BOOST_VARIANT2_VARIANT_COLLECTION_HPP_INCLUDED
+#define BOOST_VARIANT2_VARIANT_COLLECTION_HPP_INCLUDED
+
+//  Copyright 2017 Peter Dimov.
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#ifndef BOOST_VARIANT2_VARIANT_HPP_INCLUDED
+#include <boost/variant2/variant.hpp>
+#endif
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//
+
+namespace boost
+{
+namespace variant2
+{
+
+// variant_collection
+//
+// An unordered collection of variant<T...> values that keeps the values
+// holding each alternative in a contiguous segment of their own, a
+// std::vector<T>, so that they can be processed a segment at a time
+// without dispatching on each element
+
+template<class... T> class variant_collection
+{
+private:
+
+    static_assert( sizeof...(T) > 0, "variant_collection requires at least one alternative" );
+    static_assert( mp_all<std::is_same<T, std::remove_cv_t<std::remove_reference_t<T>>>...>::value, "The alternatives of variant_collection must be non-const object types" );
+
+    std::tuple<std::vector<T>...> st_;
+
+public:
+
+    using value_type = variant<T...>;
+    using size_type = std::size_t;
+
+    template<std::size_t I> using segment_type = std::vector<mp_at_c<mp_list<T...>, I>>;
+
+    // constructors
+
+    variant_collection() = default;
+
+    // capacity
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    std::size_t size() const noexcept
+    {
+        std::size_t r = 0;
+
+        mp_for_each<mp_iota_c<sizeof...(T)>>( [&]( auto I ){
+
+            r += std::get<I>( st_ ).size();
+
+        });
+
+        return r;
+    }
+
+    template<std::size_t I> std::size_t size() const noexcept
+    {
+        return std::get<I>( st_ ).size();
+    }
+
+    template<class U, class I = mp_find<mp_list<T...>, U>, class E = std::enable_if_t<I::value != sizeof...(T)>> std::size_t size() const noexcept
+    {
+        return std::get<I::value>( st_ ).size();
+    }
+
+    template<std::size_t I> void reserve( std::size_t n )
+    {
+        std::get<I>( st_ ).reserve( n );
+    }
+
+    template<class U, class I = mp_find<mp_list<T...>, U>, class E = std::enable_if_t<I::value != sizeof...(T)>> void reserve( std::size_t n )
+    {
+        std::get<I::value>( st_ ).reserve( n );
+    }
+
+    // segments
+    //
+    // the values holding the alternative I, in insertion order; values
+    // can be modified, erased or reordered through the segment
+
+    template<std::size_t I> segment_type<I> & segment() noexcept
+    {
+        return std::get<I>( st_ );
+    }
+
+    template<std::size_t I> segment_type<I> const & segment() const noexcept
+    {
+        return std::get<I>( st_ );
+    }
+
+    template<class U, class I = mp_find<mp_list<T...>, U>, class E = std::enable_if_t<I::value != sizeof...(T)>> segment_type<I::value> & segment() noexcept
+    {
+        return std::get<I::value>( st_ );
+    }
+
+    template<class U, class I = mp_find<mp_list<T...>, U>, class E = std::enable_if_t<I::value != sizeof...(T)>> segment_type<I::value> const & segment() const noexcept
+    {
+        return std::get<I::value>( st_ );
+    }
+
+    // for_each
+    //
+    // calls f on every value, a segment at a time, in the order of the
+    // alternatives; f is called with a statically typed reference and
+    // there is no dispatch per element
+
+    template<class F> F for_each( F f )
+    {
+        mp_for_each<mp_iota_c<sizeof...(T)>>( [&]( auto I ){
+
+            for( auto& x: std::get<I>( st_ ) )
+            {
+                f( x );
+            }
+
+        });
+
+        return f;
+    }
+
+    template<class F> F for_each( F f ) const
+    {
+        mp_for_each<mp_iota_c<sizeof...(T)>>( [&]( auto I ){
+
+            for( auto const& x: std::get<I>( st_ ) )
+            {
+                f( x );
+            }
+
+        });
+
+        return f;
+    }
+
+    // modifiers
+
+    template<std::size_t I, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<mp_list<T...>, I>, A&&...>::value>> mp_at_c<mp_list<T...>, I>& emplace( A&&... a )
+    {
+        auto& st = std::get<I>( st_ );
+
+        st.emplace_back( std::forward<A>(a)... );
+        return st.back();
+    }
+
+    template<class U, class... A, class I = mp_find<mp_list<T...>, U>, class E = std::enable_if_t<I::value != sizeof...(T) && std::is_constructible<U, A&&...>::value>> U& emplace( A&&... a )
+    {
+        return emplace<I::value>( std::forward<A>(a)... );
+    }
+
+    template<class U,
+        class E1 = std::enable_if_t<!std::is_same<std::decay_t<U>, variant<T...>>::value>,
+        class V = variant2::detail::resolve_overload_type<U&&, T...>,
+        class E2 = std::enable_if_t<std::is_constructible<V, U&&>::value>
+        >
+    V& insert( U&& u )
+    {
+        return emplace<variant2::detail::resolve_overload_index<U&&, T...>::value>( std::forward<U>(u) );
+    }
+
+    void insert( variant<T...> const& v )
+    {
+        variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+            this->template emplace<I>( get<I>( v ) );
+
+        });
+    }
+
+    void insert( variant<T...>&& v )
+    {
+        variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+            this->template emplace<I>( get<I>( std::move( v ) ) );
+
+        });
+    }
+
+    void clear() noexcept
+    {
+        mp_for_each<mp_iota_c<sizeof...(T)>>( [&]( auto I ){
+
+            std::get<I>( st_ ).clear();
+
+        });
+    }
+
+    void swap( variant_collection& r ) noexcept
+    {
+        st_.swap( r.st_ );
+    }
+};
+
+// specialized algorithms
+
+template<class... T> void swap( variant_collection<T...> & v, variant_collection<T...> & w ) noexcept
+{
+    v.swap( w );
+}
+
+} // namespace variant2
+} // namespace boost
+
+#endif // #ifndef BOOST_VARIANT2_VARIANT_COLLECTION_HPP_INCLUDED
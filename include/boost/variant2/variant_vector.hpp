@@ -0,0 +1,643 @@
+#ifndef BOOST_VARIANT2_VARIANT_VECTOR_HPP_INCLUDED
+#define BOOST_VARIANT2_VARIANT_VECTOR_HPP_INCLUDED
+
+//  Copyright 2017 Peter Dimov.
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//
+//  See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt
+
+#ifndef BOOST_VARIANT2_VARIANT_HPP_INCLUDED
+#include <boost/variant2/variant.hpp>
+#endif
+#include <boost/variant2/algorithm.hpp>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <cassert>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+//
+
+namespace boost
+{
+namespace variant2
+{
+
+// forward declarations
+
+template<class... T> class variant_vector;
+template<bool C, class... T> class variant_vector_reference;
+template<bool C, class... T> class variant_vector_iterator;
+
+// variant_size
+
+template<bool C, class... T> struct variant_size<variant_vector_reference<C, T...>>: mp_size<mp_list<T...>>
+{
+};
+
+// variant_alternative
+
+template<std::size_t I, class... T> struct variant_alternative<I, variant_vector_reference<false, T...>>: mp_defer<mp_at, mp_list<T...>, mp_size_t<I>>
+{
+};
+
+template<std::size_t I, class... T> struct variant_alternative<I, variant_vector_reference<true, T...>>: mp_defer<mp_at, mp_list<T const...>, mp_size_t<I>>
+{
+};
+
+// variant_vector_reference
+//
+// Refers to an element of a variant_vector; acts as a variant whose
+// alternatives can be accessed and modified, but not changed
+
+template<bool C, class... T> class variant_vector_reference
+{
+private:
+
+    friend class variant_vector<T...>;
+    friend class variant_vector_iterator<C, T...>;
+    friend class variant_vector_reference<!C, T...>;
+
+    using container = mp_if_c<C, variant_vector<T...> const, variant_vector<T...>>;
+
+    container * p_;
+    std::size_t i_;
+
+    variant_vector_reference( container * p, std::size_t i ) noexcept: p_( p ), i_( i )
+    {
+    }
+
+public:
+
+    variant_vector_reference( variant_vector_reference const& ) = default;
+
+    template<bool C2, class E = std::enable_if_t<C && !C2>> variant_vector_reference( variant_vector_reference<C2, T...> const& r ) noexcept: p_( r.p_ ), i_( r.i_ )
+    {
+    }
+
+    // the alternative of the element can't be changed, and rebinding the
+    // reference would make v[0] = v[1] a silent no-op
+
+    variant_vector_reference& operator=( variant_vector_reference const& ) = delete;
+
+    // value status
+
+    std::size_t index() const noexcept
+    {
+        return p_->ix_[ i_ ];
+    }
+
+    // conversion
+
+    operator variant<T...>() const
+    {
+        return variant2::detail::dispatch_index<sizeof...(T)>( index(), [&]( auto I ){
+
+            return variant<T...>( in_place_index_t<I>(), _get_impl( I ) );
+
+        });
+    }
+
+    // private accessors
+
+    template<std::size_t I> variant_alternative_t<I, variant_vector_reference> & _get_impl( mp_size_t<I> ) const noexcept
+    {
+        assert( index() == I );
+        return std::get<I>( p_->st_ )[ p_->ox_[ i_ ] ];
+    }
+};
+
+// variant_vector_iterator
+//
+// A random access iterator whose reference type is variant_vector_reference
+
+template<bool C, class... T> class variant_vector_iterator
+{
+private:
+
+    friend class variant_vector<T...>;
+    friend class variant_vector_iterator<!C, T...>;
+
+    using container = mp_if_c<C, variant_vector<T...> const, variant_vector<T...>>;
+
+    container * p_;
+    std::size_t i_;
+
+    variant_vector_iterator( container * p, std::size_t i ) noexcept: p_( p ), i_( i )
+    {
+    }
+
+public:
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = variant<T...>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = variant_vector_reference<C, T...>;
+
+    variant_vector_iterator() noexcept: p_( 0 ), i_( 0 )
+    {
+    }
+
+    template<bool C2, class E = std::enable_if_t<C && !C2>> variant_vector_iterator( variant_vector_iterator<C2, T...> const& r ) noexcept: p_( r.p_ ), i_( r.i_ )
+    {
+    }
+
+    reference operator*() const noexcept
+    {
+        return reference( p_, i_ );
+    }
+
+    reference operator[]( difference_type n ) const noexcept
+    {
+        return reference( p_, i_ + n );
+    }
+
+    variant_vector_iterator& operator++() noexcept
+    {
+        ++i_;
+        return *this;
+    }
+
+    variant_vector_iterator operator++( int ) noexcept
+    {
+        variant_vector_iterator r( *this );
+        ++i_;
+        return r;
+    }
+
+    variant_vector_iterator& operator--() noexcept
+    {
+        --i_;
+        return *this;
+    }
+
+    variant_vector_iterator operator--( int ) noexcept
+    {
+        variant_vector_iterator r( *this );
+        --i_;
+        return r;
+    }
+
+    variant_vector_iterator& operator+=( difference_type n ) noexcept
+    {
+        i_ += n;
+        return *this;
+    }
+
+    variant_vector_iterator& operator-=( difference_type n ) noexcept
+    {
+        i_ -= n;
+        return *this;
+    }
+
+    friend variant_vector_iterator operator+( variant_vector_iterator it, difference_type n ) noexcept
+    {
+        return it += n;
+    }
+
+    friend variant_vector_iterator operator+( difference_type n, variant_vector_iterator it ) noexcept
+    {
+        return it += n;
+    }
+
+    friend variant_vector_iterator operator-( variant_vector_iterator it, difference_type n ) noexcept
+    {
+        return it -= n;
+    }
+
+    friend difference_type operator-( variant_vector_iterator const& a, variant_vector_iterator const& b ) noexcept
+    {
+        return static_cast<difference_type>( a.i_ ) - static_cast<difference_type>( b.i_ );
+    }
+
+    friend bool operator==( variant_vector_iterator const& a, variant_vector_iterator const& b ) noexcept
+    {
+        return a.i_ == b.i_;
+    }
+
+    friend bool operator!=( variant_vector_iterator const& a, variant_vector_iterator const& b ) noexcept
+    {
+        return a.i_ != b.i_;
+    }
+
+    friend bool operator<( variant_vector_iterator const& a, variant_vector_iterator const& b ) noexcept
+    {
+        return a.i_ < b.i_;
+    }
+
+    friend bool operator>( variant_vector_iterator const& a, variant_vector_iterator const& b ) noexcept
+    {
+        return a.i_ > b.i_;
+    }
+
+    friend bool operator<=( variant_vector_iterator const& a, variant_vector_iterator const& b ) noexcept
+    {
+        return a.i_ <= b.i_;
+    }
+
+    friend bool operator>=( variant_vector_iterator const& a, variant_vector_iterator const& b ) noexcept
+    {
+        return a.i_ >= b.i_;
+    }
+
+    // private accessors
+
+    variant2::detail::smallest_unsigned_type<sizeof...(T)> const * _index_ptr() const noexcept
+    {
+        return p_->ix_.data() + i_;
+    }
+
+    std::size_t const * _offset_ptr() const noexcept
+    {
+        return p_->ox_.data() + i_;
+    }
+
+    template<class I> mp_at<mp_list<T...>, I> const * _alternative_data( I ) const noexcept
+    {
+        return std::get<I::value>( p_->st_ ).data();
+    }
+};
+
+// variant_vector
+//
+// A sequence of variant<T...> values stored as a structure of arrays: the
+// index of each element in a compact array of the smallest integer type
+// that can hold it, and the alternatives in one array per alternative,
+// with an offset per element locating it there. Elements can be appended
+// and removed from the back; the alternative an element holds can't be
+// changed in place.
+
+template<class... T> class variant_vector
+{
+private:
+
+    static_assert( sizeof...(T) > 0, "variant_vector requires at least one alternative" );
+    static_assert( mp_all<std::is_same<T, std::remove_cv_t<std::remove_reference_t<T>>>...>::value, "The alternatives of variant_vector must be non-const object types" );
+
+    template<bool C, class... U> friend class variant_vector_reference;
+    template<bool C, class... U> friend class variant_vector_iterator;
+
+    std::vector<variant2::detail::smallest_unsigned_type<sizeof...(T)>> ix_;
+    std::vector<std::size_t> ox_;
+    std::tuple<std::vector<T>...> st_;
+
+public:
+
+    using value_type = variant<T...>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using index_type = variant2::detail::smallest_unsigned_type<sizeof...(T)>;
+
+    using reference = variant_vector_reference<false, T...>;
+    using const_reference = variant_vector_reference<true, T...>;
+
+    using iterator = variant_vector_iterator<false, T...>;
+    using const_iterator = variant_vector_iterator<true, T...>;
+
+    // constructors
+
+    variant_vector() = default;
+
+    // capacity
+
+    bool empty() const noexcept
+    {
+        return ix_.empty();
+    }
+
+    std::size_t size() const noexcept
+    {
+        return ix_.size();
+    }
+
+    void reserve( std::size_t n )
+    {
+        ix_.reserve( n );
+        ox_.reserve( n );
+    }
+
+    // element access
+
+    reference operator[]( std::size_t i ) noexcept
+    {
+        assert( i < size() );
+        return reference( this, i );
+    }
+
+    const_reference operator[]( std::size_t i ) const noexcept
+    {
+        assert( i < size() );
+        return const_reference( this, i );
+    }
+
+    reference back() noexcept
+    {
+        assert( !empty() );
+        return reference( this, size() - 1 );
+    }
+
+    const_reference back() const noexcept
+    {
+        assert( !empty() );
+        return const_reference( this, size() - 1 );
+    }
+
+    // the index of each element, in order
+
+    std::vector<index_type> const & indices() const noexcept
+    {
+        return ix_;
+    }
+
+    // the elements holding the alternative I, in order
+
+    template<std::size_t I> std::vector<mp_at_c<mp_list<T...>, I>> const & alternative() const noexcept
+    {
+        return std::get<I>( st_ );
+    }
+
+    // iterators
+
+    iterator begin() noexcept
+    {
+        return iterator( this, 0 );
+    }
+
+    iterator end() noexcept
+    {
+        return iterator( this, size() );
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator( this, 0 );
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator( this, size() );
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    // modifiers
+
+    template<std::size_t I, class... A, class E = std::enable_if_t<std::is_constructible<mp_at_c<mp_list<T...>, I>, A&&...>::value>> reference emplace_back( A&&... a )
+    {
+        auto& st = std::get<I>( st_ );
+
+        // make room in ix_ and ox_ up front, so that the push_backs below
+        // can't throw; growing geometrically keeps appending linear
+
+        if( ix_.size() == ix_.capacity() || ox_.size() == ox_.capacity() )
+        {
+            reserve( size() < 8? 16: size() * 2 );
+        }
+
+        st.emplace_back( std::forward<A>(a)... );
+
+        ix_.push_back( static_cast<index_type>( I ) );
+        ox_.push_back( st.size() - 1 );
+
+        return back();
+    }
+
+    template<class U, class... A, class I = mp_find<mp_list<T...>, U>, class E = std::enable_if_t<I::value != sizeof...(T) && std::is_constructible<U, A&&...>::value>> reference emplace_back( A&&... a )
+    {
+        return emplace_back<I::value>( std::forward<A>(a)... );
+    }
+
+    template<class U,
+        class E1 = std::enable_if_t<!std::is_same<std::decay_t<U>, variant<T...>>::value>,
+        class V = variant2::detail::resolve_overload_type<U&&, T...>,
+        class E2 = std::enable_if_t<std::is_constructible<V, U&&>::value>
+        >
+    reference push_back( U&& u )
+    {
+        return emplace_back<variant2::detail::resolve_overload_index<U&&, T...>::value>( std::forward<U>(u) );
+    }
+
+    reference push_back( variant<T...> const& v )
+    {
+        return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+            return this->template emplace_back<I>( get<I>( v ) );
+
+        });
+    }
+
+    reference push_back( variant<T...>&& v )
+    {
+        return variant2::detail::dispatch_index<sizeof...(T)>( v.index(), [&]( auto I ){
+
+            return this->template emplace_back<I>( get<I>( std::move( v ) ) );
+
+        });
+    }
+
+    void pop_back() noexcept
+    {
+        assert( !empty() );
+
+        variant2::detail::dispatch_index<sizeof...(T)>( ix_.back(), [&]( auto I ){
+
+            std::get<I>( st_ ).pop_back();
+
+        });
+
+        ix_.pop_back();
+        ox_.pop_back();
+    }
+
+    void clear() noexcept
+    {
+        ix_.clear();
+        ox_.clear();
+
+        mp_for_each<mp_iota_c<sizeof...(T)>>( [&]( auto I ){
+
+            std::get<I>( st_ ).clear();
+
+        });
+    }
+
+    void swap( variant_vector& r ) noexcept
+    {
+        ix_.swap( r.ix_ );
+        ox_.swap( r.ox_ );
+        st_.swap( r.st_ );
+    }
+};
+
+// holds_alternative
+
+template<class U, bool C, class... T> bool holds_alternative( variant_vector_reference<C, T...> const& r ) noexcept
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    return r.index() == mp_find<mp_list<T...>, U>::value;
+}
+
+// get (index)
+//
+// variant_vector_reference refers to the element, so get returns an
+// lvalue for it regardless of the value category of the reference
+
+template<std::size_t I, bool C, class... T> variant_alternative_t<I, variant_vector_reference<C, T...>> & get( variant_vector_reference<C, T...> const& r )
+{
+    static_assert( I < sizeof...(T), "Index out of bounds" );
+
+    if( r.index() != I ) throw bad_variant_access();
+    return r._get_impl( mp_size_t<I>() );
+}
+
+// get (type)
+
+template<class U, bool C, class... T> variant_alternative_t<mp_find<mp_list<T...>, U>::value, variant_vector_reference<C, T...>> & get( variant_vector_reference<C, T...> const& r )
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    constexpr auto I = mp_find<mp_list<T...>, U>::value;
+
+    if( r.index() != I ) throw bad_variant_access();
+    return r._get_impl( mp_size_t<I>() );
+}
+
+// get_if
+
+template<std::size_t I, bool C, class... T> variant_alternative_t<I, variant_vector_reference<C, T...>> * get_if( variant_vector_reference<C, T...> const * r ) noexcept
+{
+    static_assert( I < sizeof...(T), "Index out of bounds" );
+    return r && r->index() == I? &r->_get_impl( mp_size_t<I>() ): 0;
+}
+
+template<class U, bool C, class... T> variant_alternative_t<mp_find<mp_list<T...>, U>::value, variant_vector_reference<C, T...>> * get_if( variant_vector_reference<C, T...> const * r ) noexcept
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    constexpr auto I = mp_find<mp_list<T...>, U>::value;
+
+    return r && r->index() == I? &r->_get_impl( mp_size_t<I>() ): 0;
+}
+
+// visitation
+//
+// visit() works with variant_vector_reference through variant_size,
+// variant_alternative and get
+
+// count_alternative, find_alternative, select_alternative
+//
+// Scan the compact index array of the elements instead of visiting them
+
+template<class U, bool C, class... T> std::size_t count_alternative( variant_vector_iterator<C, T...> first, variant_vector_iterator<C, T...> last ) noexcept
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    using index_type = variant2::detail::smallest_unsigned_type<sizeof...(T)>;
+
+    return variant2::detail::count_index( first._index_ptr(), static_cast<std::size_t>( last - first ), static_cast<index_type>( mp_find<mp_list<T...>, U>::value ) );
+}
+
+template<class U, bool C, class... T> variant_vector_iterator<C, T...> find_alternative( variant_vector_iterator<C, T...> first, variant_vector_iterator<C, T...> last ) noexcept
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    using index_type = variant2::detail::smallest_unsigned_type<sizeof...(T)>;
+
+    return first + variant2::detail::find_index( first._index_ptr(), static_cast<std::size_t>( last - first ), static_cast<index_type>( mp_find<mp_list<T...>, U>::value ) );
+}
+
+template<class U, bool C, class... T, class Out> Out select_alternative( variant_vector_iterator<C, T...> first, variant_vector_iterator<C, T...> last, Out out )
+{
+    static_assert( mp_count<mp_list<T...>, U>::value == 1, "The type must occur exactly once in the list of variant alternatives" );
+    using index_type = variant2::detail::smallest_unsigned_type<sizeof...(T)>;
+
+    return variant2::detail::select_index( first._index_ptr(), static_cast<std::size_t>( last - first ), static_cast<index_type>( mp_find<mp_list<T...>, U>::value ), 0, out );
+}
+
+// equal_range_of_variants
+//
+// Compares the index arrays of the ranges with memcmp; since the elements
+// holding a given alternative are stored in order, those of each range are
+// then a contiguous block of the array of that alternative, and blocks of
+// bitwise comparable alternatives are compared with memcmp as well
+
+namespace detail
+{
+
+template<bool C1, bool C2, class... T> bool equal_range_of_variants_impl( variant_vector_iterator<C1, T...> first1, variant_vector_iterator<C1, T...> last1, variant_vector_iterator<C2, T...> first2, mp_false )
+{
+    return equal_range_runs( first1, last1, first2 );
+}
+
+template<bool C1, bool C2, class... T> bool equal_range_of_variants_impl( variant_vector_iterator<C1, T...> first1, variant_vector_iterator<C1, T...> last1, variant_vector_iterator<C2, T...> first2, mp_true )
+{
+    using index_type = smallest_unsigned_type<sizeof...(T)>;
+
+    std::size_t const n = static_cast<std::size_t>( last1 - first1 );
+
+    if( n == 0 ) return true;
+
+    index_type const * ix = first1._index_ptr();
+
+    if( std::memcmp( ix, first2._index_ptr(), n * sizeof( index_type ) ) != 0 ) return false;
+
+    bool r = true;
+
+    mp_for_each<mp_iota_c<sizeof...(T)>>( [&]( auto I ){
+
+        if( !r ) return;
+
+        std::size_t m = count_index( ix, n, static_cast<index_type>( I ) );
+
+        if( m == 0 ) return;
+
+        std::size_t k = find_index( ix, n, static_cast<index_type>( I ) );
+
+        auto p1 = first1._alternative_data( I ) + first1._offset_ptr()[ k ];
+        auto p2 = first2._alternative_data( I ) + first2._offset_ptr()[ k ];
+
+        r = std::memcmp( p1, p2, m * sizeof( *p1 ) ) == 0;
+
+    });
+
+    return r;
+}
+
+} // namespace detail
+
+template<bool C1, bool C2, class... T> bool equal_range_of_variants( variant_vector_iterator<C1, T...> first1, variant_vector_iterator<C1, T...> last1, variant_vector_iterator<C2, T...> first2 )
+{
+    return variant2::detail::equal_range_of_variants_impl( first1, last1, first2, mp_all<is_bitwise_comparable<T>...>() );
+}
+
+template<class... T> bool operator==( variant_vector<T...> const & v, variant_vector<T...> const & w )
+{
+    return v.size() == w.size() && equal_range_of_variants( v.begin(), v.end(), w.begin() );
+}
+
+template<class... T> bool operator!=( variant_vector<T...> const & v, variant_vector<T...> const & w )
+{
+    return !( v == w );
+}
+
+// specialized algorithms
+
+template<class... T> void swap( variant_vector<T...> & v, variant_vector<T...> & w ) noexcept
+{
+    v.swap( w );
+}
+
+} // namespace variant2
+} // namespace boost
+
+#endif // #ifndef BOOST_VARIANT2_VARIANT_VECTOR_HPP_INCLUDED
@@ -0,0 +1,145 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <type_traits>
+#include <utility>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+using namespace boost::variant2;
+
+#define STATIC_ASSERT(...) static_assert(__VA_ARGS__, #__VA_ARGS__)
+
+enum E
+{
+    e
+};
+
+struct X
+{
+    int v;
+
+    X( int v = 0 ): v( v ) {}
+    X( E ): v( 0 ) { throw std::runtime_error( "X(E)" ); }
+    X( X const& r ): v( r.v ) {}
+    X( X&& r ): v( r.v ) {}
+    X& operator=( X const& ) = default;
+    X& operator=( X&& ) = default;
+};
+
+bool operator==( X const& a, X const& b ) { return a.v == b.v; }
+bool operator!=( X const& a, X const& b ) { return a.v != b.v; }
+bool operator<( X const& a, X const& b ) { return a.v < b.v; }
+
+STATIC_ASSERT( !std::is_nothrow_move_constructible<X>::value );
+
+using V = basic_variant<variant_policy::may_be_valueless, std::string, X>;
+using W = basic_variant<variant_policy::never_valueless, std::string, X>;
+
+STATIC_ASSERT( variant_size<V>::value == 2 );
+STATIC_ASSERT( std::is_same<variant_alternative_t<1, V>, X>::value );
+STATIC_ASSERT( std::is_same<variant_alternative_t<0, V const>, std::string const>::value );
+
+STATIC_ASSERT( sizeof( V ) < sizeof( variant<std::string, X> ) );
+STATIC_ASSERT( sizeof( W ) == sizeof( variant<std::string, X> ) );
+STATIC_ASSERT( sizeof( basic_variant<variant_policy::may_be_valueless, std::string, std::vector<int>> ) == sizeof( variant<std::string, std::vector<int>> ) );
+
+int main()
+{
+    {
+        V v;
+
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST( !v.valueless_by_exception() );
+        BOOST_TEST_EQ( get<0>( v ), "" );
+
+        v = X( 1 );
+
+        BOOST_TEST_EQ( v.index(), 1 );
+        BOOST_TEST( holds_alternative<X>( v ) );
+        BOOST_TEST_EQ( get<X>( v ).v, 1 );
+        BOOST_TEST_EQ( get_if<1>( &v )->v, 1 );
+        BOOST_TEST( get_if<std::string>( &v ) == 0 );
+
+        v = "abc";
+
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST_EQ( get<std::string>( v ), "abc" );
+
+        try
+        {
+            v.emplace<X>( e );
+            BOOST_ERROR( "`v.emplace<X>( e );` failed to throw" );
+        }
+        catch( std::exception const& )
+        {
+        }
+
+        BOOST_TEST( v.valueless_by_exception() );
+        BOOST_TEST_EQ( v.index(), variant_npos );
+        BOOST_TEST( !holds_alternative<std::string>( v ) );
+        BOOST_TEST( !holds_alternative<X>( v ) );
+        BOOST_TEST_THROWS( get<0>( v ), bad_variant_access );
+        BOOST_TEST_THROWS( get<X>( v ), bad_variant_access );
+        BOOST_TEST( get_if<0>( &v ) == 0 );
+        BOOST_TEST_THROWS( visit( []( auto const& ){}, v ), bad_variant_access );
+
+        V v2( v );
+        BOOST_TEST( v2.valueless_by_exception() );
+        BOOST_TEST( v == v2 );
+        BOOST_TEST( v < V() );
+
+        v.emplace<1>( 2 );
+
+        BOOST_TEST_EQ( v.index(), 1 );
+        BOOST_TEST_EQ( get<1>( v ).v, 2 );
+        BOOST_TEST( v2 < v );
+        BOOST_TEST( v != v2 );
+
+        swap( v, v2 );
+
+        BOOST_TEST( v.valueless_by_exception() );
+        BOOST_TEST_EQ( get<1>( v2 ).v, 2 );
+    }
+
+    {
+        V v( in_place_index<1>, 3 );
+        BOOST_TEST_EQ( get<1>( v ).v, 3 );
+
+        V v2( in_place_type<std::string>, 2, 'x' );
+        BOOST_TEST_EQ( get<0>( v2 ), "xx" );
+
+        BOOST_TEST_EQ( visit( []( auto const& x ){ return sizeof( x ); }, v ), sizeof( X ) );
+        BOOST_TEST_EQ( visit( []( auto const& x, auto const& y ){ return sizeof( x ) + sizeof( y ); }, v, v2 ), sizeof( X ) + sizeof( std::string ) );
+
+        V v3( std::move( v2 ) );
+        BOOST_TEST_EQ( get<0>( v3 ), "xx" );
+        BOOST_TEST_EQ( get<0>( std::move( v3 ) ), "xx" );
+    }
+
+    {
+        W w( X( 4 ) );
+
+        try
+        {
+            w.emplace<X>( e );
+            BOOST_ERROR( "`w.emplace<X>( e );` failed to throw" );
+        }
+        catch( std::exception const& )
+        {
+        }
+
+        BOOST_TEST( !w.valueless_by_exception() );
+        BOOST_TEST_EQ( w.index(), 1 );
+        BOOST_TEST_EQ( get<1>( w ).v, 4 );
+    }
+
+    return boost::report_errors();
+}
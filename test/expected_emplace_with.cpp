@@ -0,0 +1,99 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/expected.hpp>
+#include <boost/variant2/result.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/config.hpp>
+#include <string>
+#include <system_error>
+
+using namespace boost::variant2;
+
+#if BOOST_CXX_VERSION >= 201703L
+
+// neither copyable nor movable
+struct Z
+{
+    int v;
+
+    explicit Z( int v ): v( v ) {}
+
+    Z( Z const& ) = delete;
+    Z& operator=( Z const& ) = delete;
+};
+
+#endif
+
+int main()
+{
+    {
+        expected<std::string, std::error_code> x( in_place_factory, []{ return std::string( "abc" ); } );
+
+        BOOST_TEST( x.has_value() );
+        BOOST_TEST_EQ( *x, "abc" );
+
+        x = unexpected_<std::error_code>( std::make_error_code( std::errc::invalid_argument ) );
+
+        BOOST_TEST( !x.has_value() );
+
+        std::string& s = x.emplace_with( []{ return std::string( "def" ); } );
+
+        BOOST_TEST( x.has_value() );
+        BOOST_TEST_EQ( &s, &*x );
+        BOOST_TEST_EQ( s, "def" );
+    }
+
+#if BOOST_CXX_VERSION >= 201703L
+
+    {
+        expected<Z, std::error_code> x( in_place_factory, []{ return Z( 1 ); } );
+
+        BOOST_TEST_EQ( x->v, 1 );
+
+        Z& z = x.emplace_with( []{ return Z( 2 ); } );
+
+        BOOST_TEST_EQ( &z, &*x );
+        BOOST_TEST_EQ( z.v, 2 );
+    }
+
+#endif
+
+    {
+        result<std::string> r( in_place_factory, []{ return std::string( "abc" ); } );
+
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST_EQ( *r, "abc" );
+
+        r.set_error( std::make_error_code( std::errc::invalid_argument ) );
+
+        BOOST_TEST( r.has_error() );
+
+        std::string& s = r.emplace_with( []{ return "def"; } );
+
+        BOOST_TEST( r.has_value() );
+        BOOST_TEST_EQ( &s, &*r );
+        BOOST_TEST_EQ( s, "def" );
+    }
+
+#if BOOST_CXX_VERSION >= 201703L
+
+    {
+        result<Z> r( in_place_factory, []{ return Z( 1 ); } );
+
+        BOOST_TEST_EQ( r->v, 1 );
+
+        Z& z = r.emplace_with( []{ return Z( 2 ); } );
+
+        BOOST_TEST_EQ( &z, &*r );
+        BOOST_TEST_EQ( z.v, 2 );
+    }
+
+#endif
+
+    return boost::report_errors();
+}
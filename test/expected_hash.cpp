@@ -0,0 +1,77 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/expected.hpp>
+#include <boost/variant2/result.hpp>
+#include <boost/variant2/outcome.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <exception>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <unordered_set>
+
+using namespace boost::variant2;
+
+// no std::hash
+
+struct Y
+{
+};
+
+#define STATIC_ASSERT(...) static_assert(__VA_ARGS__, #__VA_ARGS__)
+
+STATIC_ASSERT( std::is_default_constructible<std::hash<expected<int, std::error_code>>>::value );
+STATIC_ASSERT( std::is_default_constructible<std::hash<result<int>>>::value );
+STATIC_ASSERT( std::is_default_constructible<std::hash<outcome<int>>>::value );
+
+STATIC_ASSERT( !std::is_default_constructible<std::hash<expected<Y, std::error_code>>>::value );
+STATIC_ASSERT( !std::is_default_constructible<std::hash<expected<int, Y>>>::value );
+STATIC_ASSERT( !std::is_default_constructible<std::hash<result<Y>>>::value );
+STATIC_ASSERT( !std::is_default_constructible<std::hash<outcome<Y>>>::value );
+
+template<class V> std::size_t h( V const& v )
+{
+    return std::hash<V>()( v );
+}
+
+int main()
+{
+    {
+        using E = expected<int, std::error_code, std::string>;
+
+        BOOST_TEST_EQ( h( E( 1 ) ), h( E( 1 ) ) );
+        BOOST_TEST_NE( h( E( 1 ) ), h( E( 2 ) ) );
+        BOOST_TEST_EQ( h( E( unexpected_<std::string>( "e" ) ) ), h( E( unexpected_<std::string>( "e" ) ) ) );
+
+        std::unordered_set<E> s;
+
+        s.insert( E( 1 ) );
+        s.insert( E( unexpected_<std::string>( "e" ) ) );
+        s.insert( E( 1 ) );
+
+        BOOST_TEST_EQ( s.size(), 2 );
+        BOOST_TEST_EQ( s.count( E( 1 ) ), 1 );
+        BOOST_TEST_EQ( s.count( E( 2 ) ), 0 );
+    }
+
+    {
+        std::error_code ec = std::make_error_code( std::errc::invalid_argument );
+
+        BOOST_TEST_EQ( h( result<int>( 1 ) ), h( result<int>( 1 ) ) );
+        BOOST_TEST_EQ( h( result<int>( ec ) ), h( result<int>( ec ) ) );
+        BOOST_TEST_NE( h( result<int>( 1 ) ), h( result<int>( 2 ) ) );
+
+        BOOST_TEST_EQ( h( outcome<int>( 1 ) ), h( outcome<int>( 1 ) ) );
+        BOOST_TEST_EQ( h( outcome<int>( ec ) ), h( outcome<int>( ec ) ) );
+        BOOST_TEST_EQ( h( outcome<int>( std::make_exception_ptr( 1 ) ) ), h( outcome<int>( std::make_exception_ptr( 2 ) ) ) );
+        BOOST_TEST_NE( h( outcome<int>( 1 ) ), h( outcome<int>( 2 ) ) );
+    }
+
+    return boost::report_errors();
+}
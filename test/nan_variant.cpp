@@ -0,0 +1,195 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/nan_variant.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <cstdint>
+#include <limits>
+
+using namespace boost::variant2;
+
+struct Object
+{
+    int v;
+};
+
+enum E
+{
+    e1 = 1,
+    e2 = -7
+};
+
+using V = nan_variant<double, std::int32_t, bool, monostate, Object*>;
+
+#define STATIC_ASSERT(...) static_assert(__VA_ARGS__, #__VA_ARGS__)
+
+STATIC_ASSERT( sizeof( V ) == 8 );
+STATIC_ASSERT( sizeof( nan_variant<monostate, double, E, char, std::uint16_t> ) == 8 );
+STATIC_ASSERT( variant_size<V>::value == 5 );
+STATIC_ASSERT( std::is_same<variant_alternative_t<4, V>, Object*>::value );
+STATIC_ASSERT( std::is_trivially_copyable<V>::value );
+
+int main()
+{
+    Object obj{ 5 };
+
+    {
+        V v;
+
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST_EQ( get<double>( v ), 0.0 );
+
+        v = 3.5;
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST_EQ( get<0>( v ), 3.5 );
+
+        v = -1;
+        BOOST_TEST_EQ( v.index(), 1 );
+        BOOST_TEST_EQ( get<std::int32_t>( v ), -1 );
+
+        v = std::numeric_limits<std::int32_t>::min();
+        BOOST_TEST_EQ( get<1>( v ), std::numeric_limits<std::int32_t>::min() );
+
+        v = true;
+        BOOST_TEST_EQ( v.index(), 2 );
+        BOOST_TEST_EQ( get<bool>( v ), true );
+
+        v = false;
+        BOOST_TEST_EQ( v.index(), 2 );
+        BOOST_TEST_EQ( get<bool>( v ), false );
+
+        v = monostate();
+        BOOST_TEST_EQ( v.index(), 3 );
+        BOOST_TEST( holds_alternative<monostate>( v ) );
+
+        v = &obj;
+        BOOST_TEST_EQ( v.index(), 4 );
+        BOOST_TEST_EQ( get<Object*>( v )->v, 5 );
+
+        v = static_cast<Object*>( nullptr );
+        BOOST_TEST_EQ( v.index(), 4 );
+        BOOST_TEST( get<4>( v ) == nullptr );
+
+        BOOST_TEST_THROWS( get<double>( v ), bad_variant_access );
+        BOOST_TEST_THROWS( get<0>( v ), bad_variant_access );
+    }
+
+    {
+        V v( 2.5 );
+
+        BOOST_TEST( get_if<double>( &v ) );
+        BOOST_TEST_EQ( *get_if<double>( &v ), 2.5 );
+        BOOST_TEST_EQ( *get_if<0>( &v ), 2.5 );
+        BOOST_TEST( !get_if<std::int32_t>( &v ) );
+        BOOST_TEST( !get_if<Object*>( &v ) );
+        BOOST_TEST( !get_if<double>( static_cast<V const*>( nullptr ) ) );
+
+        v = &obj;
+
+        BOOST_TEST( get_if<Object*>( &v ) );
+        BOOST_TEST_EQ( ( *get_if<Object*>( &v ) )->v, 5 );
+        BOOST_TEST( !get_if<double>( &v ) );
+
+        // a held nullptr or 0 is told apart from another alternative
+
+        v = static_cast<Object*>( nullptr );
+
+        BOOST_TEST( get_if<Object*>( &v ) );
+        BOOST_TEST( *get_if<Object*>( &v ) == nullptr );
+
+        v = 0;
+
+        BOOST_TEST( get_if<std::int32_t>( &v ) );
+        BOOST_TEST_EQ( *get_if<1>( &v ), 0 );
+        BOOST_TEST( !get_if<Object*>( &v ) );
+    }
+
+    {
+        double const inf = std::numeric_limits<double>::infinity();
+        double const nan = std::numeric_limits<double>::quiet_NaN();
+
+        V v( -inf );
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST_EQ( get<double>( v ), -inf );
+
+        v = -nan;
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST( get<double>( v ) != get<double>( v ) );
+        BOOST_TEST( v != v );
+
+        v = -0.0;
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST( v == V( 0.0 ) );
+    }
+
+    {
+        nan_variant<monostate, double, E, char, std::uint16_t> v;
+
+        BOOST_TEST_EQ( v.index(), 0 );
+
+        v = e2;
+        BOOST_TEST_EQ( v.index(), 2 );
+        BOOST_TEST_EQ( get<E>( v ), e2 );
+
+        v = 'x';
+        BOOST_TEST_EQ( v.index(), 3 );
+        BOOST_TEST_EQ( get<char>( v ), 'x' );
+
+        v.emplace<std::uint16_t>( 65535 );
+        BOOST_TEST_EQ( v.index(), 4 );
+        BOOST_TEST_EQ( get<4>( v ), 65535 );
+
+        BOOST_TEST_EQ( v.emplace<1>( 2.0 ), 2.0 );
+        BOOST_TEST_EQ( v.index(), 1 );
+
+        nan_variant<monostate, double, E, char, std::uint16_t> v2( in_place_index<2>, e1 ), v3( in_place_type<char>, 'a' );
+
+        BOOST_TEST_EQ( get<2>( v2 ), e1 );
+        BOOST_TEST_EQ( get<3>( v3 ), 'a' );
+    }
+
+    {
+        V v( 1.5 ), w( 2 );
+
+        BOOST_TEST_EQ( visit( []( auto x ){ return sizeof( x ); }, v ), sizeof( double ) );
+        BOOST_TEST_EQ( visit( []( auto x ){ return sizeof( x ); }, w ), sizeof( std::int32_t ) );
+
+        struct F
+        {
+            double operator()( double x ) const { return x; }
+            double operator()( std::int32_t x ) const { return x; }
+            double operator()( bool ) const { return -1; }
+            double operator()( monostate ) const { return -2; }
+            double operator()( Object* p ) const { return p->v; }
+        };
+
+        BOOST_TEST_EQ( visit( F(), v ), 1.5 );
+        BOOST_TEST_EQ( visit( F(), w ), 2.0 );
+        BOOST_TEST_EQ( visit( F(), V( &obj ) ), 5.0 );
+
+        BOOST_TEST_EQ( visit( []( auto x, auto y ){ return sizeof( x ) + sizeof( y ); }, v, w ), sizeof( double ) + sizeof( std::int32_t ) );
+    }
+
+    {
+        V v( 1.0 ), v2( 1.0 ), w( 1 ), n( monostate{} );
+
+        BOOST_TEST( v == v2 );
+        BOOST_TEST( v != w );
+        BOOST_TEST( v < w );
+        BOOST_TEST( w > v );
+        BOOST_TEST( v <= v2 );
+        BOOST_TEST( w >= v );
+        BOOST_TEST( n == V( monostate{} ) );
+
+        swap( v, w );
+
+        BOOST_TEST_EQ( get<std::int32_t>( v ), 1 );
+        BOOST_TEST_EQ( get<double>( w ), 1.0 );
+    }
+
+    return boost::report_errors();
+}
@@ -0,0 +1,253 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/packed_variant_buffer.hpp>
+#include <boost/variant2/algorithm.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/lightweight_test_trait.hpp>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+using namespace boost::variant2;
+
+struct Big
+{
+    int v;
+    char data[ 256 ];
+};
+
+using PB = packed_variant_buffer<char, double, std::string, Big>;
+
+#define STATIC_ASSERT(...) static_assert(__VA_ARGS__, #__VA_ARGS__)
+
+// *it = *jt would rebind the reference instead of assigning the element
+
+STATIC_ASSERT( !std::is_copy_assignable<PB::reference>::value );
+STATIC_ASSERT( !std::is_copy_assignable<PB::const_reference>::value );
+STATIC_ASSERT( std::is_copy_constructible<PB::reference>::value );
+
+struct F
+{
+    int operator()( char x ) const { return x; }
+    int operator()( double x ) const { return static_cast<int>( x * 10 ); }
+    int operator()( std::string const& s ) const { return static_cast<int>( s.size() ) * 100; }
+    int operator()( Big const& b ) const { return b.v * 1000; }
+};
+
+struct Twice
+{
+    template<class T> void operator()( T& x ) const { x = x + x; }
+    void operator()( Big& b ) const { b.v *= 2; }
+};
+
+template<class It> int sum( It first, It last )
+{
+    int s = 0;
+
+    for( ; first != last; ++first )
+    {
+        s += visit( F(), *first );
+    }
+
+    return s;
+}
+
+int main()
+{
+    BOOST_TEST_EQ( (variant_size<PB::reference>::value), 4 );
+    BOOST_TEST_TRAIT_TRUE((std::is_same<variant_alternative_t<2, PB::reference>, std::string>));
+    BOOST_TEST_TRAIT_TRUE((std::is_same<variant_alternative_t<2, PB::const_reference>, std::string const>));
+    BOOST_TEST_TRAIT_TRUE((std::is_same<std::iterator_traits<PB::iterator>::iterator_category, std::forward_iterator_tag>));
+
+    {
+        PB v;
+
+        BOOST_TEST( v.empty() );
+        BOOST_TEST_EQ( v.size(), 0 );
+        BOOST_TEST_EQ( v.size_bytes(), 0 );
+        BOOST_TEST( v.begin() == v.end() );
+    }
+
+    {
+        PB v;
+
+        v.push_back( '\3' );
+        v.push_back( 2.5 );
+        v.push_back( std::string( "abc" ) );
+        v.emplace_back<Big>( Big{ 4, {} } );
+        v.emplace_back<0>( '\5' );
+        v.push_back( variant<char, double, std::string, Big>( std::string( "de" ) ) );
+
+        BOOST_TEST_EQ( v.size(), 6 );
+
+        PB::iterator it = v.begin();
+
+        BOOST_TEST_EQ( (*it).index(), 0 );
+        BOOST_TEST_EQ( get<0>( *it ), '\3' );
+        ++it;
+        BOOST_TEST_EQ( (*it).index(), 1 );
+        BOOST_TEST_EQ( get<double>( *it ), 2.5 );
+        ++it;
+        BOOST_TEST_EQ( (*it).index(), 2 );
+        BOOST_TEST_EQ( get<2>( *it ), std::string( "abc" ) );
+        it++;
+        BOOST_TEST_EQ( get<Big>( *it ).v, 4 );
+        BOOST_TEST_THROWS( get<0>( *it ), bad_variant_access );
+        ++it;
+        BOOST_TEST( holds_alternative<char>( *it ) );
+        BOOST_TEST_EQ( get<char>( *it ), '\5' );
+        ++it;
+        BOOST_TEST_EQ( get<std::string>( *it ), std::string( "de" ) );
+        ++it;
+        BOOST_TEST( it == v.end() );
+
+        BOOST_TEST_EQ( sum( v.begin(), v.end() ), '\3' + 25 + 300 + 4000 + '\5' + 200 );
+        BOOST_TEST_EQ( sum( v.cbegin(), v.cend() ), '\3' + 25 + 300 + 4000 + '\5' + 200 );
+
+        PB::reference r = *v.begin();
+
+        BOOST_TEST( get_if<char>( &r ) != 0 );
+        BOOST_TEST( get_if<1>( &r ) == 0 );
+
+        variant<char, double, std::string, Big> w = *std::next( v.begin(), 2 );
+        BOOST_TEST_EQ( get<2>( w ), std::string( "abc" ) );
+
+        for( PB::reference x: v )
+        {
+            visit( Twice(), x );
+        }
+
+        BOOST_TEST_EQ( sum( v.begin(), v.end() ), 2 * '\3' + 50 + 600 + 8000 + 2 * '\5' + 400 );
+
+        int s = 0;
+        visit_each( v.begin(), v.end(), [&]( auto const& x ){ s += F()( x ); } );
+        BOOST_TEST_EQ( s, 2 * '\3' + 50 + 600 + 8000 + 2 * '\5' + 400 );
+    }
+
+    {
+        // only the held alternative takes space
+
+        PB v;
+
+        for( int i = 0; i < 1000; ++i )
+        {
+            v.push_back( static_cast<char>( i ) );
+        }
+
+        BOOST_TEST_EQ( v.size(), 1000 );
+        BOOST_TEST_EQ( v.size_bytes(), 2000 );
+
+        v.emplace_back<Big>( Big{ 1, {} } );
+
+        BOOST_TEST_EQ( v.size(), 1001 );
+        BOOST_TEST_LE( v.size_bytes(), 2000 + alignof( Big ) + sizeof( Big ) + 1 );
+    }
+
+    {
+        // copy, move, growth with non-trivial alternatives
+
+        PB v;
+
+        for( int i = 0; i < 200; ++i )
+        {
+            v.push_back( std::string( i % 30, 'x' ) );
+            v.push_back( 0.5 );
+        }
+
+        int const s1 = sum( v.begin(), v.end() );
+
+        PB v2( v );
+
+        BOOST_TEST_EQ( v2.size(), v.size() );
+        BOOST_TEST_EQ( v2.size_bytes(), v.size_bytes() );
+        BOOST_TEST_EQ( sum( v2.begin(), v2.end() ), s1 );
+
+        PB v3( std::move( v2 ) );
+
+        BOOST_TEST( v2.empty() );
+        BOOST_TEST_EQ( sum( v3.begin(), v3.end() ), s1 );
+
+        v2 = v3;
+        BOOST_TEST_EQ( sum( v2.begin(), v2.end() ), s1 );
+
+        v3.clear();
+        BOOST_TEST( v3.empty() );
+        BOOST_TEST( v3.begin() == v3.end() );
+
+        v3.push_back( 'c' );
+        swap( v2, v3 );
+
+        BOOST_TEST_EQ( v2.size(), 1 );
+        BOOST_TEST_EQ( v3.size(), 400 );
+
+        v3 = std::move( v2 );
+        BOOST_TEST_EQ( v3.size(), 1 );
+
+        v3.reserve_bytes( 100000 );
+        BOOST_TEST_GE( v3.capacity_bytes(), 100000 );
+        BOOST_TEST_EQ( get<char>( *v3.begin() ), 'c' );
+    }
+
+    {
+        // pushing an element of the buffer itself, while it grows
+
+        packed_variant_buffer<int, std::string> v;
+
+        v.push_back( std::string( 200, 'x' ) );
+
+        for( int i = 0; i < 20; ++i )
+        {
+            v.push_back( get<1>( *v.begin() ) );
+        }
+
+        BOOST_TEST_EQ( v.size(), 21 );
+        BOOST_TEST_GT( v.capacity_bytes(), 256 );
+
+        for( auto it = v.begin(); it != v.end(); ++it )
+        {
+            BOOST_TEST_EQ( get<1>( *it ), std::string( 200, 'x' ) );
+        }
+    }
+
+    {
+        // move-only alternatives, not trivially relocatable
+
+        packed_variant_buffer<int, std::unique_ptr<int>> v;
+
+        for( int i = 0; i < 200; ++i )
+        {
+            v.emplace_back<int>( i );
+            v.emplace_back<std::unique_ptr<int>>( new int( i ) );
+        }
+
+        BOOST_TEST_EQ( v.size(), 400 );
+
+        packed_variant_buffer<int, std::unique_ptr<int>> v2( std::move( v ) );
+
+        BOOST_TEST( v.empty() );
+        BOOST_TEST_EQ( v2.size(), 400 );
+
+        int i = 0;
+
+        for( auto it = v2.begin(); it != v2.end(); ++it, ++i )
+        {
+            if( i % 2 == 0 )
+            {
+                BOOST_TEST_EQ( get<int>( *it ), i / 2 );
+            }
+            else
+            {
+                BOOST_TEST_EQ( *get<std::unique_ptr<int>>( *it ), i / 2 );
+            }
+        }
+    }
+
+    return boost::report_errors();
+}
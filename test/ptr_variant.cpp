@@ -0,0 +1,214 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/ptr_variant.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+using namespace boost::variant2;
+
+struct A
+{
+    std::int64_t v;
+};
+
+struct B
+{
+    std::int64_t v;
+};
+
+struct C
+{
+    std::int32_t v;
+};
+
+struct D: A
+{
+};
+
+// self-referential node types, incomplete when ptr_variant is instantiated
+
+struct Num;
+
+struct Add
+{
+    ptr_variant<Add*, Num*> lhs, rhs;
+};
+
+struct Num
+{
+    std::int64_t v;
+};
+
+std::int64_t eval( ptr_variant<Add*, Num*> e )
+{
+    return e.index() == 1? get<1>( e )->v: eval( get<0>( e )->lhs ) + eval( get<0>( e )->rhs );
+}
+
+#define STATIC_ASSERT(...) static_assert(__VA_ARGS__, #__VA_ARGS__)
+
+STATIC_ASSERT( sizeof( ptr_variant<A*, B*> ) == sizeof( void* ) );
+STATIC_ASSERT( sizeof( ptr_variant<A*, B*, C*, A const*> ) == sizeof( void* ) );
+STATIC_ASSERT( variant_size<ptr_variant<A*, B*, C*>>::value == 3 );
+STATIC_ASSERT( std::is_same<variant_alternative_t<1, ptr_variant<A*, B*, C*>>, B*>::value );
+STATIC_ASSERT( std::is_trivially_copyable<ptr_variant<A*, B*>>::value );
+STATIC_ASSERT( sizeof( Add ) == 2 * sizeof( void* ) );
+
+int main()
+{
+    A a{ 1 };
+    B b{ 2 };
+    C c{ 3 };
+    D d;
+
+    d.v = 4;
+
+    {
+        ptr_variant<A*, B*, C*> v;
+
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST( holds_alternative<A*>( v ) );
+        BOOST_TEST( get<0>( v ) == nullptr );
+    }
+
+    {
+        ptr_variant<A*, B*, C*> v( &b );
+
+        BOOST_TEST_EQ( v.index(), 1 );
+        BOOST_TEST( holds_alternative<B*>( v ) );
+        BOOST_TEST_EQ( get<B*>( v ), &b );
+        BOOST_TEST_EQ( get<1>( v ), &b );
+        BOOST_TEST_THROWS( get<A*>( v ), bad_variant_access );
+        BOOST_TEST_THROWS( get<2>( v ), bad_variant_access );
+
+        BOOST_TEST( get_if<B*>( &v ) );
+        BOOST_TEST_EQ( *get_if<B*>( &v ), &b );
+        BOOST_TEST_EQ( *get_if<1>( &v ), &b );
+        BOOST_TEST( !get_if<0>( &v ) );
+        BOOST_TEST( !get_if<C*>( &v ) );
+        BOOST_TEST( !get_if<B*>( static_cast<ptr_variant<A*, B*, C*> const*>( nullptr ) ) );
+
+        v = &c;
+
+        BOOST_TEST_EQ( v.index(), 2 );
+        BOOST_TEST_EQ( get<C*>( v )->v, 3 );
+
+        v = &a;
+
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST_EQ( get<A*>( v )->v, 1 );
+
+        v = &d;
+
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST_EQ( get<A*>( v )->v, 4 );
+    }
+
+    {
+        ptr_variant<A*, B*, C*> v( in_place_type<B*> );
+
+        BOOST_TEST_EQ( v.index(), 1 );
+        BOOST_TEST( get<1>( v ) == nullptr );
+
+        // a held nullptr is told apart from another alternative
+
+        BOOST_TEST( get_if<B*>( &v ) );
+        BOOST_TEST( *get_if<B*>( &v ) == nullptr );
+        BOOST_TEST( !get_if<A*>( &v ) );
+
+        ptr_variant<A*, B*, C*> v2( in_place_index<2>, &c );
+
+        BOOST_TEST_EQ( v2.index(), 2 );
+        BOOST_TEST_EQ( get<2>( v2 ), &c );
+
+        BOOST_TEST_EQ( v.emplace<C*>( &c ), &c );
+        BOOST_TEST_EQ( v.index(), 2 );
+
+        BOOST_TEST( v.emplace<0>() == nullptr );
+        BOOST_TEST_EQ( v.index(), 0 );
+    }
+
+    {
+        ptr_variant<A*, A const*> v( &a );
+
+        BOOST_TEST_EQ( v.index(), 0 );
+
+        A const& ra = a;
+        v = &ra;
+
+        BOOST_TEST_EQ( v.index(), 1 );
+        BOOST_TEST_EQ( get<1>( v ), &a );
+    }
+
+    {
+        ptr_variant<A*, B*, C*> v( &a ), w( &b );
+
+        BOOST_TEST_EQ( visit( []( auto p ){ return static_cast<long>( p->v ); }, v ), 1 );
+        BOOST_TEST_EQ( visit( []( auto const& p ){ return static_cast<long>( p->v ); }, w ), 2 );
+        BOOST_TEST_EQ( visit( []( auto p ){ return static_cast<long>( p->v ); }, ptr_variant<A*, B*, C*>( &c ) ), 3 );
+
+        BOOST_TEST_EQ( visit( []( auto p, auto q ){ return static_cast<long>( p->v * 10 + q->v ); }, v, w ), 12 );
+
+        variant<int, std::string> x( 5 );
+        BOOST_TEST_EQ( visit( []( auto p, auto const& y ){ return static_cast<std::size_t>( p->v ) + sizeof( y ); }, w, x ), 2 + sizeof( int ) );
+    }
+
+    {
+        ptr_variant<A*, B*, C*> v( &a ), v2( &a ), w( &b ), n( in_place_type<B*> );
+
+        BOOST_TEST( v == v2 );
+        BOOST_TEST( !( v != v2 ) );
+        BOOST_TEST( v != w );
+        BOOST_TEST( n != (ptr_variant<A*, B*, C*>()) );
+
+        BOOST_TEST( v < w );
+        BOOST_TEST( w > v );
+        BOOST_TEST( v <= v2 );
+        BOOST_TEST( v >= v2 );
+        BOOST_TEST( !( v < v2 ) );
+    }
+
+    {
+        // the same alternative, ordered as std::less orders the pointers
+
+        A a2{ 5 };
+
+        ptr_variant<A*, B*, C*> v( &a ), w( &a2 );
+
+        bool const lt = std::less<A*>()( &a, &a2 );
+
+        BOOST_TEST_EQ( v < w, lt );
+        BOOST_TEST_EQ( w < v, !lt );
+        BOOST_TEST_EQ( v > w, !lt );
+        BOOST_TEST_EQ( v <= w, lt );
+        BOOST_TEST_EQ( v >= w, !lt );
+    }
+
+    {
+        Num n1{ 1 }, n2{ 2 }, n3{ 3 };
+
+        Add x{ &n1, &n2 };
+        Add y{ &x, &n3 };
+
+        BOOST_TEST_EQ( eval( &y ), 6 );
+        BOOST_TEST_EQ( eval( y.lhs ), 3 );
+        BOOST_TEST_EQ( eval( &n3 ), 3 );
+    }
+
+    {
+        ptr_variant<A*, B*, C*> v( &a ), w( &c );
+
+        swap( v, w );
+
+        BOOST_TEST_EQ( get<C*>( v ), &c );
+        BOOST_TEST_EQ( get<A*>( w ), &a );
+    }
+
+    return boost::report_errors();
+}
@@ -0,0 +1,18 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/ptr_variant.hpp>
+
+using namespace boost::variant2;
+
+// three alternatives, but char* has no spare low bits
+
+int main()
+{
+    ptr_variant<int*, long*, char*> v;
+    (void)v;
+}
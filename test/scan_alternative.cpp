@@ -0,0 +1,106 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/algorithm.hpp>
+#include <boost/variant2/variant_vector.hpp>
+#include <boost/variant2/variant.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace boost::variant2;
+
+using V = variant<int, double, std::string>;
+using VV = variant_vector<int, double, std::string>;
+
+template<class It> void test( It first, It last, std::vector<V> const& w )
+{
+    std::size_t n = w.size();
+
+    std::size_t c = 0;
+    std::size_t f = n;
+    std::vector<std::size_t> s;
+
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        if( holds_alternative<double>( w[ i ] ) )
+        {
+            ++c;
+            if( f == n ) f = i;
+            s.push_back( i );
+        }
+    }
+
+    BOOST_TEST_EQ( count_alternative<double>( first, last ), c );
+    BOOST_TEST_EQ( find_alternative<double>( first, last ) - first, static_cast<std::ptrdiff_t>( f ) );
+
+    std::vector<std::size_t> s2;
+    select_alternative<double>( first, last, std::back_inserter( s2 ) );
+
+    BOOST_TEST( s2 == s );
+}
+
+static void test( std::vector<V> const& w )
+{
+    test( w.begin(), w.end(), w );
+
+    VV v;
+
+    for( auto const& x: w ) v.push_back( x );
+
+    test( v.begin(), v.end(), w );
+
+    VV const& cv = v;
+    test( cv.begin(), cv.end(), w );
+
+    BOOST_TEST_EQ( v.indices().size(), w.size() );
+}
+
+int main()
+{
+    test( {} );
+    test( { V( 1 ) } );
+    test( { V( 1.0 ) } );
+    test( { V( 1 ), V( "a" ), V( 2.0 ), V( 3 ), V( 4.0 ) } );
+
+    for( std::size_t n: { 15, 16, 17, 31, 32, 33, 100, 1000, 20000 } )
+    {
+        std::vector<V> w;
+
+        // doubles are rare, and not in the first block
+
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            if( i >= 40 && i % 37 == 3 ) w.push_back( 0.5 ); else if( i % 3 ) w.push_back( 1 ); else w.push_back( "x" );
+        }
+
+        test( w );
+
+        // only doubles
+
+        test( std::vector<V>( n, V( 0.5 ) ) );
+    }
+
+    {
+        VV v;
+
+        v.push_back( 1 );
+        v.push_back( 2.5 );
+        v.push_back( 3 );
+
+        BOOST_TEST_EQ( count_alternative<int>( v.begin() + 1, v.end() ), 1 );
+        BOOST_TEST( find_alternative<int>( v.begin() + 1, v.end() ) == v.begin() + 2 );
+        BOOST_TEST( find_alternative<std::string>( v.begin(), v.end() ) == v.end() );
+
+        std::size_t s[ 3 ] = {};
+        BOOST_TEST_EQ( select_alternative<int>( v.begin() + 1, v.end(), s ) - s, 1 );
+        BOOST_TEST_EQ( s[ 0 ], 1 );
+    }
+
+    return boost::report_errors();
+}
@@ -0,0 +1,210 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/variant2/algorithm.hpp>
+#include <boost/variant2/variant_vector.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/lightweight_test_trait.hpp>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+using namespace boost::variant2;
+
+enum E { e1, e2, e3 };
+
+struct X
+{
+    int a, b;
+};
+
+bool operator==( X const& x, X const& y )
+{
+    return x.a == y.a && x.b == y.b;
+}
+
+bool operator!=( X const& x, X const& y )
+{
+    return !( x == y );
+}
+
+struct Y
+{
+    int a;
+    double b;
+};
+
+bool operator==( Y const& x, Y const& y )
+{
+    return x.a == y.a && x.b == y.b;
+}
+
+namespace boost
+{
+namespace variant2
+{
+
+template<> struct is_bitwise_comparable<X>: std::true_type
+{
+};
+
+} // namespace variant2
+} // namespace boost
+
+int main()
+{
+    BOOST_TEST_TRAIT_TRUE(( is_bitwise_comparable<int> ));
+    BOOST_TEST_TRAIT_TRUE(( is_bitwise_comparable<std::uint32_t const> ));
+    BOOST_TEST_TRAIT_TRUE(( is_bitwise_comparable<E> ));
+    BOOST_TEST_TRAIT_TRUE(( is_bitwise_comparable<X> ));
+    BOOST_TEST_TRAIT_FALSE(( is_bitwise_comparable<double> ));
+    BOOST_TEST_TRAIT_FALSE(( is_bitwise_comparable<Y> ));
+    BOOST_TEST_TRAIT_FALSE(( is_bitwise_comparable<std::string> ));
+
+    {
+        using V = variant<std::int64_t, std::uint32_t, E>;
+
+        V v1( std::int64_t( 1 ) ), v2( std::uint32_t( 1 ) ), v3( e2 );
+
+        BOOST_TEST( v1 == V( std::int64_t( 1 ) ) );
+        BOOST_TEST( v1 != V( std::int64_t( 2 ) ) );
+        BOOST_TEST( v1 != v2 );
+        BOOST_TEST( v2 == V( std::uint32_t( 1 ) ) );
+        BOOST_TEST( v2 != V( std::uint32_t( 2 ) ) );
+        BOOST_TEST( v3 == V( e2 ) );
+        BOOST_TEST( v3 != V( e3 ) );
+        BOOST_TEST( v2 != v3 );
+
+        // the bytes past the held alternative don't take part
+
+        v1 = std::int64_t( -1 );
+        v1 = std::uint32_t( 7 );
+
+        BOOST_TEST( v1 == V( std::uint32_t( 7 ) ) );
+        BOOST_TEST_NOT( v1 != V( std::uint32_t( 7 ) ) );
+    }
+
+    {
+        using V = variant<int, X>;
+
+        BOOST_TEST( V( X{ 1, 2 } ) == V( X{ 1, 2 } ) );
+        BOOST_TEST( V( X{ 1, 2 } ) != V( X{ 1, 3 } ) );
+        BOOST_TEST( V( 1 ) != V( X{ 1, 2 } ) );
+    }
+
+    {
+        using V = variant<int, Y>;
+
+        BOOST_TEST( V( Y{ 1, 0.0 } ) == V( Y{ 1, -0.0 } ) );
+        BOOST_TEST_NOT( V( Y{ 1, 0.5 } ) == V( Y{ 1, 1.5 } ) );
+    }
+
+    {
+        using V = variant<std::int64_t, std::uint32_t, E>;
+
+        std::vector<V> v1, v2;
+        variant_vector<std::int64_t, std::uint32_t, E> w1, w2;
+
+        for( int i = 0; i < 1000; ++i )
+        {
+            V v;
+
+            switch( i % 7 % 3 )
+            {
+            case 0: v = std::int64_t( i ); break;
+            case 1: v = std::uint32_t( i ); break;
+            case 2: v = static_cast<E>( i % 3 ); break;
+            }
+
+            v1.push_back( v );
+            v2.push_back( v );
+            w1.push_back( v );
+            w2.push_back( v );
+        }
+
+        BOOST_TEST( equal_range_of_variants( v1.begin(), v1.end(), v2.begin() ) );
+        BOOST_TEST( equal_range_of_variants( w1.begin(), w1.end(), w2.begin() ) );
+        BOOST_TEST( equal_range_of_variants( w1.begin(), w1.end(), w2.cbegin() ) );
+        BOOST_TEST( equal_range_of_variants( v1.begin(), v1.end(), w1.begin() ) );
+        BOOST_TEST( equal_range_of_variants( w1.begin() + 100, w1.begin() + 900, w2.begin() + 100 ) );
+        BOOST_TEST( equal_range_of_variants( w1.begin(), w1.begin(), w2.end() ) );
+        BOOST_TEST( w1 == w2 );
+        BOOST_TEST_NOT( w1 != w2 );
+
+        v2[ 500 ] = std::int64_t( -1 );
+        w2.pop_back();
+        w2.push_back( std::uint32_t( 999 ) );
+
+        BOOST_TEST_NOT( equal_range_of_variants( v1.begin(), v1.end(), v2.begin() ) );
+        BOOST_TEST( equal_range_of_variants( v1.begin(), v1.begin() + 500, v2.begin() ) );
+        BOOST_TEST_NOT( equal_range_of_variants( w1.begin(), w1.end(), w2.begin() ) );
+        BOOST_TEST( equal_range_of_variants( w1.begin(), w1.end() - 1, w2.begin() ) );
+        BOOST_TEST( w1 != w2 );
+
+        w2.pop_back();
+        w2.push_back( std::uint32_t( 998 ) );
+
+        BOOST_TEST_NOT( equal_range_of_variants( w1.begin(), w1.end(), w2.begin() ) );
+        BOOST_TEST( w1 != w2 );
+
+        w2.pop_back();
+
+        BOOST_TEST( w1 != w2 );
+
+        // offsets into the alternative arrays differ between the ranges
+
+        variant_vector<std::int64_t, std::uint32_t, E> w3;
+
+        for( int i = 0; i < 84; ++i )
+        {
+            switch( i % 7 % 3 )
+            {
+            case 0: w3.push_back( std::int64_t( i % 21 ) ); break;
+            case 1: w3.push_back( std::uint32_t( i % 21 ) ); break;
+            case 2: w3.push_back( static_cast<E>( i % 3 ) ); break;
+            }
+        }
+
+        w3.pop_back();
+        w3.push_back( std::int64_t( -1 ) );
+
+        BOOST_TEST( equal_range_of_variants( w3.begin() + 21, w3.begin() + 42, w3.begin() + 42 ) );
+        BOOST_TEST( equal_range_of_variants( w3.begin(), w3.begin() + 42, w3.begin() + 21 ) );
+        BOOST_TEST_NOT( equal_range_of_variants( w3.begin() + 21, w3.begin() + 42, w3.begin() + 63 ) );
+    }
+
+    {
+        using V = variant<int, std::string>;
+
+        std::list<V> v1 = { 1, "a", "b", 2 };
+        std::vector<V> v2( v1.begin(), v1.end() );
+
+        variant_vector<int, std::string> w;
+
+        for( auto const& v: v1 ) w.push_back( v );
+
+        BOOST_TEST( equal_range_of_variants( v1.begin(), v1.end(), v2.begin() ) );
+        BOOST_TEST( equal_range_of_variants( w.begin(), w.end(), v1.begin() ) );
+
+        v2[ 2 ] = "c";
+
+        BOOST_TEST_NOT( equal_range_of_variants( v1.begin(), v1.end(), v2.begin() ) );
+
+        variant_vector<int, std::string> w2 = w;
+
+        BOOST_TEST( w == w2 );
+
+        w2.pop_back();
+        w2.push_back( "x" );
+
+        BOOST_TEST( w != w2 );
+    }
+
+    return boost::report_errors();
+}
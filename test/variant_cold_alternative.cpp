@@ -0,0 +1,148 @@
+
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/lightweight_test_trait.hpp>
+#include <type_traits>
+#include <utility>
+#include <string>
+
+using namespace boost::variant2;
+
+static int destroyed;
+
+struct E
+{
+    std::string what;
+
+    explicit E( char const* s = "" ): what( s ) {}
+    E( E const& ) = default;
+    E( E&& ) = default;
+    E& operator=( E const& ) = default;
+    E& operator=( E&& ) = default;
+    ~E() { ++destroyed; }
+};
+
+struct Y
+{
+    int v;
+};
+
+namespace boost
+{
+namespace variant2
+{
+
+template<> struct is_cold_alternative<E>: std::true_type
+{
+};
+
+template<> struct is_cold_alternative<Y>: std::true_type
+{
+};
+
+} // namespace variant2
+} // namespace boost
+
+struct F
+{
+    int operator()( int x ) const { return x; }
+    int operator()( E const& e ) const { return static_cast<int>( e.what.size() ) + 100; }
+    int operator()( E&& e ) const { return static_cast<int>( e.what.size() ) + 200; }
+    int operator()( Y const& y ) const { return y.v + 300; }
+};
+
+struct G
+{
+    template<class A, class B> int operator()( A const& a, B const& b ) const
+    {
+        return F()( a ) * 1000 + F()( b );
+    }
+};
+
+int main()
+{
+    BOOST_TEST_TRAIT_FALSE((is_cold_alternative<int>));
+    BOOST_TEST_TRAIT_TRUE((is_cold_alternative<E>));
+
+    {
+        variant<int, E> v( 1 );
+
+        BOOST_TEST_EQ( visit( F(), v ), 1 );
+
+        v = E( "abc" );
+
+        BOOST_TEST_EQ( visit( F(), v ), 103 );
+        BOOST_TEST_EQ( visit( F(), std::move( v ) ), 203 );
+        BOOST_TEST_EQ( visit_likely<int>( F(), v ), 103 );
+    }
+
+    {
+        variant<int, E> const v( E( "ab" ) );
+
+        BOOST_TEST_EQ( visit( F(), v ), 102 );
+    }
+
+    {
+        variant<int, E> v1( E( "abcd" ) );
+
+        variant<int, E> v2( v1 );
+        BOOST_TEST_EQ( get<1>( v2 ).what, std::string( "abcd" ) );
+
+        variant<int, E> v3( std::move( v2 ) );
+        BOOST_TEST_EQ( get<1>( v3 ).what, std::string( "abcd" ) );
+
+        variant<int, E> v4( 4 );
+
+        v4 = v3;
+        BOOST_TEST_EQ( get<1>( v4 ).what, std::string( "abcd" ) );
+
+        v4 = 5;
+        BOOST_TEST_EQ( get<0>( v4 ), 5 );
+
+        v4 = std::move( v3 );
+        BOOST_TEST_EQ( get<1>( v4 ).what, std::string( "abcd" ) );
+    }
+
+    {
+        destroyed = 0;
+
+        {
+            variant<int, E> v( E( "x" ) );
+            destroyed = 0;
+        }
+
+        BOOST_TEST_EQ( destroyed, 1 );
+    }
+
+    {
+        variant<int, E> v1( 1 );
+        variant<Y, int> v2( Y{ 2 } );
+
+        BOOST_TEST_EQ( visit( G(), v1, v2 ), 1 * 1000 + 302 );
+
+        v1 = E( "ab" );
+
+        BOOST_TEST_EQ( visit( G(), v1, v2 ), 102 * 1000 + 302 );
+
+        v2 = 3;
+
+        BOOST_TEST_EQ( visit( G(), v1, v2 ), 102 * 1000 + 3 );
+    }
+
+    {
+        variant<Y, int> v( Y{ 1 } );
+        variant<Y, int> v2( v );
+
+        BOOST_TEST_EQ( get<0>( v2 ).v, 1 );
+        BOOST_TEST_EQ( visit( F(), v2 ), 301 );
+    }
+
+    return boost::report_errors();
+}
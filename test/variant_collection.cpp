@@ -0,0 +1,109 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant_collection.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/lightweight_test_trait.hpp>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace boost::variant2;
+
+using VC = variant_collection<int, double, std::string>;
+
+struct F
+{
+    int s = 0;
+
+    void operator()( int x ) { s += x; }
+    void operator()( double x ) { s += static_cast<int>( x * 10 ); }
+    void operator()( std::string const& x ) { s += static_cast<int>( x.size() ) * 100; }
+};
+
+struct Twice
+{
+    template<class T> void operator()( T& x ) const { x = x + x; }
+};
+
+int main()
+{
+    BOOST_TEST_TRAIT_TRUE((std::is_same<VC::segment_type<1>, std::vector<double>>));
+
+    {
+        VC v;
+
+        BOOST_TEST( v.empty() );
+        BOOST_TEST_EQ( v.size(), 0 );
+        BOOST_TEST_EQ( v.for_each( F() ).s, 0 );
+    }
+
+    {
+        VC v;
+
+        v.insert( 1 );
+        v.insert( 2.5 );
+        v.insert( std::string( "abc" ) );
+        v.insert( 4 );
+        v.emplace<2>( 2, 'x' );
+        v.emplace<double>( 0.5 );
+        v.insert( variant<int, double, std::string>( 7 ) );
+
+        variant<int, double, std::string> const w( std::string( "de" ) );
+        v.insert( w );
+
+        BOOST_TEST( !v.empty() );
+        BOOST_TEST_EQ( v.size(), 8 );
+
+        BOOST_TEST_EQ( v.size<0>(), 3 );
+        BOOST_TEST_EQ( v.size<double>(), 2 );
+        BOOST_TEST_EQ( v.size<std::string>(), 3 );
+
+        BOOST_TEST_EQ( v.segment<0>()[ 0 ], 1 );
+        BOOST_TEST_EQ( v.segment<0>()[ 1 ], 4 );
+        BOOST_TEST_EQ( v.segment<int>()[ 2 ], 7 );
+        BOOST_TEST_EQ( v.segment<1>()[ 0 ], 2.5 );
+        BOOST_TEST_EQ( v.segment<double>()[ 1 ], 0.5 );
+        BOOST_TEST_EQ( v.segment<2>()[ 0 ], std::string( "abc" ) );
+        BOOST_TEST_EQ( v.segment<std::string>()[ 1 ], std::string( "xx" ) );
+        BOOST_TEST_EQ( v.segment<2>()[ 2 ], std::string( "de" ) );
+
+        BOOST_TEST_EQ( v.for_each( F() ).s, 12 + 30 + 700 );
+
+        VC const& cv = v;
+        BOOST_TEST_EQ( cv.for_each( F() ).s, 12 + 30 + 700 );
+        BOOST_TEST_EQ( cv.segment<int>().size(), 3 );
+
+        v.for_each( Twice() );
+        BOOST_TEST_EQ( v.for_each( F() ).s, 24 + 60 + 1400 );
+
+        int& r = v.emplace<int>( 5 );
+        r = 6;
+        BOOST_TEST_EQ( v.segment<0>().back(), 6 );
+
+        std::string& s = v.insert( std::string( "q" ) );
+        BOOST_TEST_EQ( &s, &v.segment<2>().back() );
+
+        v.reserve<1>( 100 );
+        BOOST_TEST_GE( v.segment<1>().capacity(), 100 );
+
+        v.reserve<std::string>( 50 );
+        BOOST_TEST_GE( v.segment<2>().capacity(), 50 );
+
+        VC v2;
+        swap( v, v2 );
+
+        BOOST_TEST( v.empty() );
+        BOOST_TEST_EQ( v2.size(), 10 );
+
+        v2.clear();
+        BOOST_TEST( v2.empty() );
+    }
+
+    return boost::report_errors();
+}
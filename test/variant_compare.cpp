@@ -0,0 +1,144 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace boost::variant2;
+
+struct X
+{
+    int v;
+};
+
+bool operator<( X const& a, X const& b ) { return a.v < b.v; }
+
+struct Y
+{
+    X x;
+
+    Y( int v ): x{ v } {}
+    Y( Y const& r ): x( r.x ) {}
+    Y( Y&& r ): x( r.x ) {}
+    Y( double ) { throw 5; }
+
+    Y& operator=( Y const& ) = default;
+    Y& operator=( Y&& ) = default;
+};
+
+bool operator<( Y const& a, Y const& b ) { return a.x < b.x; }
+
+template<class V> void test_order( V const& a, V const& b )
+{
+    // a < b
+
+    BOOST_TEST_LT( compare( a, b ), 0 );
+    BOOST_TEST_GT( compare( b, a ), 0 );
+    BOOST_TEST_EQ( compare( a, a ), 0 );
+    BOOST_TEST_EQ( compare( b, b ), 0 );
+
+    BOOST_TEST( compare_less()( a, b ) );
+    BOOST_TEST( !compare_less()( b, a ) );
+    BOOST_TEST( !compare_less()( a, a ) );
+}
+
+int main()
+{
+    {
+        using V = variant<int, double, std::string>;
+
+        test_order( V( 1 ), V( 2 ) );
+        test_order( V( 5 ), V( 0.5 ) );
+        test_order( V( 0.5 ), V( 1.5 ) );
+        test_order( V( 2.5 ), V( "" ) );
+        test_order( V( "abc" ), V( "abd" ) );
+
+        V const v( 1 ), w( 1 );
+        BOOST_TEST_EQ( compare( v, w ), 0 );
+    }
+
+    {
+        using V = variant<X, int>;
+
+        test_order( V( X{ 1 } ), V( X{ 2 } ) );
+        test_order( V( X{ 7 } ), V( 1 ) );
+    }
+
+    {
+        using V = basic_variant<variant_policy::may_be_valueless, Y, int>;
+
+        test_order( V( 1 ), V( 2 ) );
+        test_order( V( Y( 3 ) ), V( 2 ) );
+
+        V v( 1 );
+
+        try { v.emplace<Y>( 1.0 ); } catch( int ) {}
+
+        BOOST_TEST( v.valueless_by_exception() );
+
+        test_order( v, V( Y( 0 ) ) );
+        test_order( v, V( 1 ) );
+    }
+
+    {
+        using V = variant<int, std::string>;
+
+        std::vector<V> v{ "b", 3, "a", 1, 2, "c" };
+
+        std::sort( v.begin(), v.end(), compare_less() );
+
+        BOOST_TEST( ( v == std::vector<V>{ 1, 2, 3, "a", "b", "c" } ) );
+
+        std::map<V, int, compare_less> m;
+
+        m[ "x" ] = 1;
+        m[ 5 ] = 2;
+        m[ "x" ] = 3;
+
+        BOOST_TEST_EQ( m.size(), 2 );
+        BOOST_TEST_EQ( m.begin()->second, 2 );
+        BOOST_TEST_EQ( m[ "x" ], 3 );
+    }
+
+#if defined( BOOST_VARIANT2_HAS_THREE_WAY_COMPARISON )
+
+    {
+        using V = variant<int, double, std::string>;
+
+        BOOST_TEST( ( V( 1 ) <=> V( 2 ) ) < 0 );
+        BOOST_TEST( ( V( 1 ) <=> V( 0.5 ) ) < 0 );
+        BOOST_TEST( ( V( "b" ) <=> V( "a" ) ) > 0 );
+        BOOST_TEST( ( V( 1.5 ) <=> V( 1.5 ) ) == 0 );
+
+        std::partial_ordering r = V( 0.0 / 0.0 ) <=> V( 1.0 );
+        BOOST_TEST( r == std::partial_ordering::unordered );
+
+        static_assert( std::is_same<decltype( variant<int, std::string>() <=> variant<int, std::string>() ), std::strong_ordering>::value, "strong_ordering" );
+    }
+
+    {
+        using V = basic_variant<variant_policy::may_be_valueless, Y, int>;
+
+        V v( 1 );
+
+        try { v.emplace<Y>( 1.0 ); } catch( int ) {}
+
+        static_assert( !std::three_way_comparable<V>, "!three_way_comparable<V>" );
+
+        using W = basic_variant<variant_policy::may_be_valueless, int, std::string>;
+
+        BOOST_TEST( ( W( 1 ) <=> W( "" ) ) < 0 );
+    }
+
+#endif
+
+    return boost::report_errors();
+}
@@ -0,0 +1,117 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <string>
+
+using namespace boost::variant2;
+
+// can't be moved without throwing, so variants holding it are double buffered
+struct X
+{
+    static int instances;
+
+    int v;
+
+    X( int v ): v( v ) { ++instances; }
+    X( X const& r ): v( r.v ) { ++instances; }
+    ~X() { --instances; }
+
+    X& operator=( X const& r ) { v = r.v; return *this; }
+};
+
+int X::instances = 0;
+
+struct Y
+{
+    int v;
+
+    explicit Y( int v ): v( v ) {}
+    Y( Y const& r ): v( r.v ) {}
+
+    Y& operator=( Y const& r ) { v = r.v; return *this; }
+};
+
+struct E
+{
+};
+
+struct Z
+{
+    int v;
+
+    explicit Z( int v ) noexcept: v( v ) {}
+    explicit Z( E ): v( 0 ) { throw E(); }
+};
+
+template<class V> void test()
+{
+    V v( 1 );
+
+    void const* p = &get<0>( v );
+
+    // nothrow alternatives are constructed in the current buffer
+
+    v.template emplace<0>( 2 );
+    BOOST_TEST_EQ( static_cast<void const*>( &get<0>( v ) ), p );
+    BOOST_TEST_EQ( get<0>( v ), 2 );
+
+    v = 3;
+    BOOST_TEST_EQ( static_cast<void const*>( &get<0>( v ) ), p );
+    BOOST_TEST_EQ( get<0>( v ), 3 );
+
+    v.template emplace<3>( 4 );
+    BOOST_TEST_EQ( static_cast<void const*>( &get<3>( v ) ), p );
+    BOOST_TEST_EQ( get<3>( v ).v, 4 );
+
+    v = 5;
+    BOOST_TEST_EQ( static_cast<void const*>( &get<0>( v ) ), p );
+
+    // those whose construction can throw go to the spare buffer
+
+    v.template emplace<1>( 6 );
+    BOOST_TEST_NE( static_cast<void const*>( &get<1>( v ) ), p );
+    BOOST_TEST_EQ( get<1>( v ).v, 6 );
+
+    void const* q = &get<1>( v );
+
+    v.template emplace<0>( 7 );
+    BOOST_TEST_EQ( static_cast<void const*>( &get<0>( v ) ), q );
+    BOOST_TEST_EQ( get<0>( v ), 7 );
+
+    v.template emplace<1>( 8 );
+    BOOST_TEST_EQ( static_cast<void const*>( &get<1>( v ) ), p );
+
+    // a throwing construction leaves the old value in place
+
+    try
+    {
+        v.template emplace<3>( E() );
+        BOOST_ERROR( "emplace<3>( E() ) should have thrown" );
+    }
+    catch( E const& )
+    {
+    }
+
+    BOOST_TEST_EQ( v.index(), 1u );
+    BOOST_TEST_EQ( get<1>( v ).v, 8 );
+
+    v.template emplace<3>( 9 );
+    BOOST_TEST_EQ( static_cast<void const*>( &get<3>( v ) ), p );
+    BOOST_TEST_EQ( get<3>( v ).v, 9 );
+}
+
+int main()
+{
+    test<variant<int, X, std::string, Z>>();
+    BOOST_TEST_EQ( X::instances, 0 );
+
+    test<variant<int, Y, float, Z>>();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,181 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/config.hpp>
+#include <string>
+
+using namespace boost::variant2;
+
+struct X
+{
+    static int moves;
+
+    int v;
+
+    explicit X( int v ): v( v ) {}
+    X( X const& r ): v( r.v ) { ++moves; }
+    X( X&& r ): v( r.v ) { ++moves; }
+
+    X& operator=( X const& r ) { v = r.v; return *this; }
+};
+
+int X::moves = 0;
+
+// nothrow movable, so variants holding it are single buffered
+struct Y
+{
+    static int moves;
+
+    int v;
+
+    explicit Y( int v ): v( v ) {}
+    Y( Y&& r ) noexcept: v( r.v ) { ++moves; }
+
+    Y& operator=( Y&& r ) noexcept { v = r.v; return *this; }
+};
+
+int Y::moves = 0;
+
+struct E
+{
+};
+
+#if BOOST_CXX_VERSION >= 201703L
+
+// neither copyable nor movable
+struct Z
+{
+    int v;
+
+    explicit Z( int v ): v( v ) {}
+
+    Z( Z const& ) = delete;
+    Z& operator=( Z const& ) = delete;
+};
+
+#endif
+
+int main()
+{
+    {
+        variant<int, X> v( in_place_factory, []{ return X( 1 ); } );
+
+        BOOST_TEST_EQ( v.index(), 1u );
+        BOOST_TEST_EQ( get<1>( v ).v, 1 );
+
+        X& x = v.emplace_with<X>( []{ return X( 2 ); } );
+
+        BOOST_TEST_EQ( &x, &get<1>( v ) );
+        BOOST_TEST_EQ( x.v, 2 );
+
+        int& i = v.emplace_with<0>( []{ return 3; } );
+
+        BOOST_TEST_EQ( &i, &get<0>( v ) );
+        BOOST_TEST_EQ( i, 3 );
+
+        v.emplace_with<1>( []{ return X( 4 ); } );
+
+        BOOST_TEST_EQ( get<1>( v ).v, 4 );
+
+#if BOOST_CXX_VERSION >= 201703L
+
+        BOOST_TEST_EQ( X::moves, 0 );
+
+#endif
+    }
+
+    {
+        variant<int, Y, std::string> v( in_place_factory, []{ return std::string( "abc" ); } );
+
+        BOOST_TEST_EQ( v.index(), 2u );
+        BOOST_TEST_EQ( get<2>( v ), "abc" );
+
+        Y::moves = 0;
+
+        v.emplace_with<Y>( []{ return Y( 1 ); } );
+
+        BOOST_TEST_EQ( get<1>( v ).v, 1 );
+
+        // Y can't be constructed from the factory without throwing, so it
+        // goes through a temporary, but the factory's result isn't moved
+
+#if BOOST_CXX_VERSION >= 201703L
+
+        BOOST_TEST_EQ( Y::moves, 1 );
+
+#endif
+
+        v.emplace_with<0>( []() noexcept { return 5; } );
+
+        BOOST_TEST_EQ( get<0>( v ), 5 );
+
+        // a converting factory
+
+        v.emplace_with<2>( []{ return "def"; } );
+
+        BOOST_TEST_EQ( get<2>( v ), "def" );
+    }
+
+    {
+        variant<int, X> v( 1 );
+
+        try
+        {
+            v.emplace_with<X>( []() -> X { throw E(); } );
+            BOOST_ERROR( "emplace_with should have thrown" );
+        }
+        catch( E const& )
+        {
+        }
+
+        BOOST_TEST_EQ( v.index(), 0u );
+        BOOST_TEST_EQ( get<0>( v ), 1 );
+    }
+
+    {
+        using V = basic_variant<variant_policy::may_be_valueless, int, X>;
+
+        V v( in_place_factory, []{ return X( 1 ); } );
+
+        BOOST_TEST_EQ( v.index(), 1u );
+        BOOST_TEST_EQ( get<1>( v ).v, 1 );
+
+        v.emplace_with<0>( []{ return 2; } );
+
+        BOOST_TEST_EQ( get<0>( v ), 2 );
+
+        try
+        {
+            v.emplace_with<X>( []() -> X { throw E(); } );
+            BOOST_ERROR( "emplace_with should have thrown" );
+        }
+        catch( E const& )
+        {
+        }
+
+        BOOST_TEST( v.valueless_by_exception() );
+    }
+
+#if BOOST_CXX_VERSION >= 201703L
+
+    {
+        variant<int, Z> v( in_place_factory, []{ return Z( 1 ); } );
+
+        BOOST_TEST_EQ( get<1>( v ).v, 1 );
+
+        v.emplace_with<0>( []{ return 2; } );
+        v.emplace_with<Z>( []{ return Z( 3 ); } );
+
+        BOOST_TEST_EQ( get<1>( v ).v, 3 );
+    }
+
+#endif
+
+    return boost::report_errors();
+}
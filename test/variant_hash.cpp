@@ -0,0 +1,149 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/variant2/algorithm.hpp>
+#include <boost/variant2/variant_vector.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+using namespace boost::variant2;
+
+struct X
+{
+    X() {}
+    X( int ) { throw 5; }
+    X( X const& ) {}
+    X( X&& ) {}
+};
+
+namespace std
+{
+
+template<> struct hash<X>
+{
+    std::size_t operator()( X const& ) const noexcept
+    {
+        return 0;
+    }
+};
+
+} // namespace std
+
+// no std::hash
+
+struct Y
+{
+};
+
+#define STATIC_ASSERT(...) static_assert(__VA_ARGS__, #__VA_ARGS__)
+
+STATIC_ASSERT( std::is_default_constructible<std::hash<variant<int, X>>>::value );
+STATIC_ASSERT( std::is_default_constructible<std::hash<variant<monostate, int const>>>::value );
+STATIC_ASSERT( std::is_default_constructible<std::hash<basic_variant<variant_policy::may_be_valueless, int, X>>>::value );
+
+STATIC_ASSERT( !std::is_default_constructible<std::hash<variant<int, Y>>>::value );
+STATIC_ASSERT( !std::is_copy_constructible<std::hash<variant<int, Y>>>::value );
+STATIC_ASSERT( !std::is_copy_assignable<std::hash<variant<int, Y>>>::value );
+STATIC_ASSERT( !std::is_default_constructible<std::hash<basic_variant<variant_policy::may_be_valueless, int, Y>>>::value );
+
+template<class V> std::size_t h( V const& v )
+{
+    return std::hash<V>()( v );
+}
+
+int main()
+{
+    {
+        using V = variant<int, long, std::string>;
+
+        BOOST_TEST_EQ( h( V( 1 ) ), h( V( 1 ) ) );
+        BOOST_TEST_EQ( h( V( "abc" ) ), h( V( std::string( "abc" ) ) ) );
+        BOOST_TEST_EQ( h( V( 1 ) ), hash_value( V( 1 ) ) );
+
+        BOOST_TEST_NE( h( V( 1 ) ), h( V( 2 ) ) );
+        BOOST_TEST_NE( h( V( 1 ) ), h( V( 1L ) ) );
+
+        std::unordered_map<V, int> m;
+
+        m[ 1 ] = 1;
+        m[ 1L ] = 2;
+        m[ "one" ] = 3;
+        m[ 1 ] = 4;
+
+        BOOST_TEST_EQ( m.size(), 3 );
+        BOOST_TEST_EQ( m[ 1 ], 4 );
+        BOOST_TEST_EQ( m[ 1L ], 2 );
+        BOOST_TEST_EQ( m[ "one" ], 3 );
+    }
+
+    {
+        using V = variant<monostate, int>;
+
+        BOOST_TEST_EQ( h( V() ), h( V() ) );
+        BOOST_TEST_NE( h( V() ), h( V( 0 ) ) );
+        BOOST_TEST_EQ( h( monostate() ), 0 );
+    }
+
+    {
+        using V = basic_variant<variant_policy::may_be_valueless, int, X>;
+
+        V v( 1 ), w( 1 );
+
+        BOOST_TEST_EQ( h( v ), h( w ) );
+
+        try { v.emplace<X>( 1 ); } catch( int ) {}
+        try { w.emplace<X>( 1 ); } catch( int ) {}
+
+        BOOST_TEST( v.valueless_by_exception() );
+        BOOST_TEST_EQ( h( v ), h( w ) );
+        BOOST_TEST_NE( h( v ), h( V( 1 ) ) );
+    }
+
+    {
+        using V = basic_variant<variant_policy::never_valueless, int, std::string>;
+
+        BOOST_TEST_EQ( h( V( "x" ) ), h( variant<int, std::string>( "x" ) ) );
+    }
+
+    {
+        using V = variant<int, long, std::string>;
+
+        std::vector<V> v;
+
+        BOOST_TEST_EQ( hash_range( v.begin(), v.end() ), 0 );
+
+        for( int i = 0; i < 100; ++i )
+        {
+            if( i % 7 == 0 ) v.push_back( std::to_string( i ) ); else if( i % 3 ) v.push_back( i ); else v.push_back( static_cast<long>( i ) );
+        }
+
+        std::vector<V> w( v );
+
+        BOOST_TEST_EQ( hash_range( v.begin(), v.end() ), hash_range( w.begin(), w.end() ) );
+
+        variant_vector<int, long, std::string> vv;
+
+        for( auto const& x: v ) vv.push_back( x );
+
+        BOOST_TEST_EQ( hash_range( vv.begin(), vv.end() ), hash_range( v.begin(), v.end() ) );
+
+        w[ 50 ] = 1000;
+        BOOST_TEST_NE( hash_range( v.begin(), v.end() ), hash_range( w.begin(), w.end() ) );
+
+        // order matters
+
+        std::vector<V> r( v.rbegin(), v.rend() );
+        BOOST_TEST_NE( hash_range( v.begin(), v.end() ), hash_range( r.begin(), r.end() ) );
+    }
+
+    return boost::report_errors();
+}
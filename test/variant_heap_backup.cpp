@@ -0,0 +1,210 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <type_traits>
+#include <utility>
+#include <string>
+#include <stdexcept>
+
+using namespace boost::variant2;
+
+#define STATIC_ASSERT(...) static_assert(__VA_ARGS__, #__VA_ARGS__)
+
+enum E
+{
+    e
+};
+
+static int instances;
+
+struct X
+{
+    int v;
+
+    X( int v = 0 ): v( v ) { ++instances; }
+    X( E ): v( 0 ) { throw std::runtime_error( "X(E)" ); }
+    X( X const& r ): v( r.v ) { ++instances; }
+    X( X&& r ): v( r.v ) { ++instances; }
+    X& operator=( X const& ) = default;
+    X& operator=( X&& ) = default;
+    ~X() { --instances; }
+};
+
+STATIC_ASSERT( !std::is_nothrow_move_constructible<X>::value );
+
+struct Y
+{
+    char v[ 3 ];
+
+    Y() {}
+    Y( E ) { throw std::runtime_error( "Y(E)" ); }
+    Y( Y const& ) {}
+    Y( Y&& ) {}
+    Y& operator=( Y const& ) = default;
+    Y& operator=( Y&& ) = default;
+};
+
+STATIC_ASSERT( !std::is_nothrow_move_constructible<Y>::value );
+STATIC_ASSERT( std::is_trivially_destructible<Y>::value );
+
+using V1 = variant<std::string, X>;
+using V2 = variant<int, Y>;
+
+namespace boost
+{
+namespace variant2
+{
+
+template<> struct use_heap_backup<V1>: std::true_type
+{
+};
+
+template<> struct use_heap_backup<V2>: std::true_type
+{
+};
+
+} // namespace variant2
+} // namespace boost
+
+STATIC_ASSERT( sizeof( V1 ) == sizeof( variant<std::string, int> ) );
+
+#if !defined( BOOST_VARIANT2_USE_HEAP_BACKUP )
+
+STATIC_ASSERT( sizeof( V1 ) < sizeof( variant<std::string, X, X> ) );
+
+#endif
+
+int main()
+{
+    {
+        V1 v( X( 1 ) );
+
+        BOOST_TEST_EQ( instances, 1 );
+        BOOST_TEST_EQ( get<X>( v ).v, 1 );
+
+        v = "abc";
+
+        BOOST_TEST_EQ( instances, 0 );
+        BOOST_TEST_EQ( get<0>( v ), "abc" );
+
+        try
+        {
+            v.emplace<X>( e );
+            BOOST_ERROR( "`v.emplace<X>( e );` failed to throw" );
+        }
+        catch( std::exception const& )
+        {
+        }
+
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST_EQ( get<0>( v ), "abc" );
+
+        V1 v2( v );
+
+        BOOST_TEST_EQ( v2.index(), 0 );
+        BOOST_TEST_EQ( get<0>( v2 ), "abc" );
+
+        get<0>( v ) += "d";
+        BOOST_TEST_EQ( get<0>( v ), "abcd" );
+
+        v2 = v;
+        BOOST_TEST_EQ( get<0>( v2 ), "abcd" );
+
+        v.emplace<X>( 2 );
+
+        BOOST_TEST_EQ( instances, 1 );
+        BOOST_TEST_EQ( get<X>( v ).v, 2 );
+
+        try
+        {
+            v.emplace<X>( e );
+            BOOST_ERROR( "`v.emplace<X>( e );` failed to throw" );
+        }
+        catch( std::exception const& )
+        {
+        }
+
+        BOOST_TEST_EQ( instances, 1 );
+        BOOST_TEST_EQ( v.index(), 1 );
+        BOOST_TEST_EQ( get<X>( v ).v, 2 );
+
+        try
+        {
+            v.emplace<X>( e );
+            BOOST_ERROR( "`v.emplace<X>( e );` failed to throw" );
+        }
+        catch( std::exception const& )
+        {
+        }
+
+        BOOST_TEST_EQ( instances, 1 );
+        BOOST_TEST_EQ( get<X>( v ).v, 2 );
+
+        V1 v3( std::move( v ) );
+
+        BOOST_TEST_EQ( instances, 2 );
+        BOOST_TEST_EQ( get<X>( v3 ).v, 2 );
+
+        swap( v2, v3 );
+
+        BOOST_TEST_EQ( get<0>( v3 ), "abcd" );
+        BOOST_TEST_EQ( get<1>( v2 ).v, 2 );
+
+        v.emplace<X>( 3 );
+
+        BOOST_TEST_EQ( instances, 2 );
+        BOOST_TEST_EQ( get<X>( v ).v, 3 );
+    }
+
+    BOOST_TEST_EQ( instances, 0 );
+
+    {
+        V1 v( X( 4 ) );
+
+        try
+        {
+            v.emplace<X>( e );
+            BOOST_ERROR( "`v.emplace<X>( e );` failed to throw" );
+        }
+        catch( std::exception const& )
+        {
+        }
+
+        BOOST_TEST_EQ( instances, 1 );
+    }
+
+    BOOST_TEST_EQ( instances, 0 );
+
+    {
+        V2 v( 5 );
+
+        try
+        {
+            v.emplace<Y>( e );
+            BOOST_ERROR( "`v.emplace<Y>( e );` failed to throw" );
+        }
+        catch( std::exception const& )
+        {
+        }
+
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST_EQ( get<0>( v ), 5 );
+
+        V2 v2( v );
+        BOOST_TEST_EQ( get<0>( v2 ), 5 );
+
+        v = Y();
+        BOOST_TEST_EQ( v.index(), 1 );
+
+        v2 = v;
+        BOOST_TEST_EQ( v2.index(), 1 );
+    }
+
+    return boost::report_errors();
+}
@@ -0,0 +1,87 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/mp11.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <cstdint>
+#include <string>
+
+using namespace boost::variant2;
+using namespace boost::mp11;
+
+template<class V> bool index_after_storage()
+{
+    return variant_index_layout<V>::value == index_layout::after_storage;
+}
+
+struct X1
+{
+    char v[ 3 ];
+    X1() {}
+    X1( X1 const& ) {}
+    X1( X1&& ) {}
+};
+
+template<class T, std::size_t N> using repeat = mp_rename<mp_repeat_c<mp_list<T>, N>, variant>;
+
+template<class V> struct D: V
+{
+    unsigned char x;
+};
+
+int main()
+{
+    BOOST_TEST(( !index_after_storage<variant<char>>() ));
+    BOOST_TEST(( !index_after_storage<variant<char, X1>>() ));
+
+    BOOST_TEST(( index_after_storage<variant<std::int16_t>>() ));
+    BOOST_TEST(( index_after_storage<variant<char, double>>() ));
+    BOOST_TEST(( index_after_storage<variant<double, std::int64_t>>() ));
+    BOOST_TEST(( index_after_storage<variant<std::int32_t, X1>>() ));
+    BOOST_TEST(( index_after_storage<variant<std::string>>() ));
+
+    BOOST_TEST(( !index_after_storage<repeat<std::int16_t, 300>>() ));
+    BOOST_TEST(( index_after_storage<repeat<std::int32_t, 300>>() ));
+
+    BOOST_TEST(( index_after_storage<variant<double> const>() ));
+    BOOST_TEST(( index_after_storage<variant<double> volatile>() ));
+    BOOST_TEST(( index_after_storage<variant<double> const volatile>() ));
+
+    BOOST_TEST_EQ( sizeof( variant<double, std::int64_t> ), 16 );
+    BOOST_TEST_EQ( sizeof( variant<std::int32_t, X1> ), 12 );
+
+#if !defined(BOOST_MSVC)
+
+    // the Itanium C++ ABI reuses the tail padding of non-POD bases
+
+    BOOST_TEST_EQ( sizeof( D<variant<double, std::int64_t>> ), 16 );
+    BOOST_TEST_EQ( sizeof( D<variant<std::int32_t, X1>> ), 12 );
+
+#endif
+
+    {
+        variant<char, double> v( 3.0 );
+        BOOST_TEST_EQ( get<1>( v ), 3.0 );
+
+        v = 'a';
+        BOOST_TEST_EQ( get<0>( v ), 'a' );
+    }
+
+    {
+        variant<std::int32_t, X1> v( 1 );
+        BOOST_TEST_EQ( get<0>( v ), 1 );
+
+        v.emplace<1>();
+        BOOST_TEST_EQ( v.index(), 1 );
+
+        v.emplace<0>( 2 );
+        BOOST_TEST_EQ( get<0>( v ), 2 );
+    }
+
+    return boost::report_errors();
+}
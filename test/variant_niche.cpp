@@ -0,0 +1,167 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <cstddef>
+#include <string>
+
+using namespace boost::variant2;
+
+struct Handle
+{
+    int id;
+
+    constexpr explicit Handle( int id = 0 ): id( id ) {}
+};
+
+constexpr bool operator==( Handle const& a, Handle const& b ) { return a.id == b.id; }
+constexpr bool operator!=( Handle const& a, Handle const& b ) { return a.id != b.id; }
+constexpr bool operator<( Handle const& a, Handle const& b ) { return a.id < b.id; }
+
+namespace boost
+{
+namespace variant2
+{
+
+template<> struct niche_traits<Handle>
+{
+    static constexpr std::size_t spare_count = 4;
+
+    static constexpr Handle spare( std::size_t i ) noexcept
+    {
+        return Handle( -1 - static_cast<int>( i ) );
+    }
+
+    static constexpr std::size_t spare_index( Handle const& h ) noexcept
+    {
+        return h.id < 0 && h.id >= -4? static_cast<std::size_t>( -1 - h.id ): 4;
+    }
+};
+
+} // namespace variant2
+} // namespace boost
+
+struct E1 {};
+struct E2 {};
+struct E3 {};
+struct E4 {};
+struct E5 {};
+
+constexpr bool operator==( E1, E1 ) { return true; }
+constexpr bool operator==( E2, E2 ) { return true; }
+
+struct F final {};
+
+struct X
+{
+    int v;
+};
+
+struct Y
+{
+    Y() {}
+};
+
+#define STATIC_ASSERT(...) static_assert(__VA_ARGS__, #__VA_ARGS__)
+
+template<class V> constexpr bool in_storage()
+{
+    return variant_index_layout<V>::value == index_layout::in_storage;
+}
+
+STATIC_ASSERT( in_storage<variant<monostate, Handle>>() );
+STATIC_ASSERT( in_storage<variant<Handle, monostate>>() );
+STATIC_ASSERT( in_storage<variant<valueless, Handle>>() );
+STATIC_ASSERT( in_storage<variant<E1, Handle, E2, E3, E4>>() );
+
+STATIC_ASSERT( !in_storage<variant<Handle>>() );
+STATIC_ASSERT( !in_storage<variant<monostate>>() );
+STATIC_ASSERT( !in_storage<variant<E1, Handle, E2, E3, E4, E5>>() );
+STATIC_ASSERT( !in_storage<variant<E1, Handle, E1>>() );
+STATIC_ASSERT( !in_storage<variant<monostate, Handle, Handle>>() );
+STATIC_ASSERT( !in_storage<variant<monostate, Handle, X>>() );
+STATIC_ASSERT( !in_storage<variant<monostate, X>>() );
+STATIC_ASSERT( !in_storage<variant<F, Handle>>() );
+STATIC_ASSERT( !in_storage<variant<Y, Handle>>() );
+
+STATIC_ASSERT( sizeof( variant<monostate, Handle> ) == sizeof( Handle ) );
+STATIC_ASSERT( sizeof( variant<E1, Handle, E2, E3, E4> ) == sizeof( Handle ) );
+
+STATIC_ASSERT( variant<monostate, Handle>().index() == 0 );
+STATIC_ASSERT( variant<monostate, Handle>( Handle( 5 ) ).index() == 1 );
+STATIC_ASSERT( get<1>( variant<monostate, Handle>( Handle( 5 ) ) ).id == 5 );
+
+int main()
+{
+    {
+        variant<monostate, Handle> v;
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST( holds_alternative<monostate>( v ) );
+
+        v = Handle( 7 );
+        BOOST_TEST_EQ( v.index(), 1 );
+        BOOST_TEST_EQ( get<Handle>( v ).id, 7 );
+
+        v.emplace<Handle>( 0 );
+        BOOST_TEST_EQ( v.index(), 1 );
+        BOOST_TEST_EQ( get<1>( v ).id, 0 );
+
+        v = monostate();
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST( get_if<1>( &v ) == 0 );
+
+        variant<monostate, Handle> v2( v );
+        BOOST_TEST_EQ( v2.index(), 0 );
+        BOOST_TEST( v == v2 );
+
+        v2 = Handle( 3 );
+        BOOST_TEST( v != v2 );
+        BOOST_TEST( v < v2 );
+
+        swap( v, v2 );
+        BOOST_TEST_EQ( v.index(), 1 );
+        BOOST_TEST_EQ( get<1>( v ).id, 3 );
+        BOOST_TEST_EQ( v2.index(), 0 );
+    }
+
+    {
+        using V = variant<E1, Handle, E2, E3, E4>;
+
+        V v;
+        BOOST_TEST_EQ( v.index(), 0 );
+
+        v.emplace<2>();
+        BOOST_TEST_EQ( v.index(), 2 );
+
+        v.emplace<1>( 9 );
+        BOOST_TEST_EQ( v.index(), 1 );
+        BOOST_TEST_EQ( get<1>( v ).id, 9 );
+
+        v.emplace<4>();
+        BOOST_TEST_EQ( v.index(), 4 );
+
+        v = E3();
+        BOOST_TEST_EQ( v.index(), 3 );
+
+        BOOST_TEST_EQ( visit( []( auto const& x ){ return sizeof( x ); }, v ), sizeof( E3 ) );
+
+        v = Handle( 1 );
+        BOOST_TEST_EQ( visit( []( auto const& x ){ return sizeof( x ); }, v ), sizeof( Handle ) );
+    }
+
+    {
+        variant<valueless, Handle> v( Handle( 2 ) );
+        BOOST_TEST_EQ( v.index(), 1 );
+
+        variant<valueless, Handle> v2( std::move( v ) );
+        BOOST_TEST_EQ( v2.index(), 1 );
+        BOOST_TEST_EQ( get<1>( v2 ).id, 2 );
+    }
+
+    return boost::report_errors();
+}
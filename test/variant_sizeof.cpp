@@ -0,0 +1,104 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/mp11.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <cstdint>
+#include <cstddef>
+
+using namespace boost::variant2;
+using namespace boost::mp11;
+
+// trivially destructible, nothrow move
+struct X1
+{
+    char v[ 3 ];
+};
+
+// not trivially destructible, nothrow move
+struct X2
+{
+    char v[ 3 ];
+    ~X2() {}
+};
+
+// trivially destructible, throwing move
+struct X3
+{
+    char v[ 3 ];
+    X3() {}
+    X3( X3 const& ) {}
+    X3( X3&& ) {}
+};
+
+// not trivially destructible, throwing move
+struct X4
+{
+    char v[ 3 ];
+    X4() {}
+    X4( X4 const& ) {}
+    X4( X4&& ) {}
+    ~X4() {}
+};
+
+template<class T, std::size_t N> using repeat = mp_rename<mp_repeat_c<mp_list<T>, N>, variant>;
+
+int main()
+{
+    // single buffered
+
+    BOOST_TEST_EQ( sizeof( variant<char> ), 2 );
+    BOOST_TEST_EQ( sizeof( variant<char, bool> ), 2 );
+    BOOST_TEST_EQ( sizeof( variant<char, bool, std::int16_t> ), 4 );
+    BOOST_TEST_EQ( sizeof( variant<std::int32_t, float> ), 8 );
+    BOOST_TEST_EQ( sizeof( variant<X1> ), 4 );
+    BOOST_TEST_EQ( sizeof( variant<X1, char> ), 4 );
+    BOOST_TEST_EQ( sizeof( variant<X2> ), 4 );
+    BOOST_TEST_EQ( sizeof( variant<X2, char> ), 4 );
+
+    // double buffered
+
+    BOOST_TEST_EQ( sizeof( variant<X3> ), 7 );
+    BOOST_TEST_EQ( sizeof( variant<X3, char> ), 7 );
+    BOOST_TEST_EQ( sizeof( variant<X4> ), 7 );
+    BOOST_TEST_EQ( sizeof( variant<X4, char> ), 7 );
+
+    // index type widening
+
+    BOOST_TEST_EQ( sizeof( repeat<char, 255> ), 2 );
+    BOOST_TEST_EQ( sizeof( repeat<char, 256> ), 2 * sizeof( unsigned short ) );
+
+    BOOST_TEST_EQ( sizeof( mp_push_back<repeat<char, 126>, X3> ), 7 );
+    BOOST_TEST_EQ( sizeof( mp_push_back<repeat<char, 127>, X3> ), 4 * sizeof( short ) );
+
+    {
+        repeat<char, 300> v( in_place_index<299>, 'a' );
+        BOOST_TEST_EQ( v.index(), 299 );
+        BOOST_TEST_EQ( get<299>( v ), 'a' );
+
+        v.emplace<256>( 'b' );
+        BOOST_TEST_EQ( v.index(), 256 );
+        BOOST_TEST_EQ( get<256>( v ), 'b' );
+    }
+
+    {
+        using V = mp_push_back<repeat<char, 200>, X3>;
+
+        V v( in_place_index<199>, 'a' );
+        BOOST_TEST_EQ( v.index(), 199 );
+
+        v.emplace<200>();
+        BOOST_TEST_EQ( v.index(), 200 );
+
+        v.emplace<150>( 'b' );
+        BOOST_TEST_EQ( v.index(), 150 );
+        BOOST_TEST_EQ( get<150>( v ), 'b' );
+    }
+
+    return boost::report_errors();
+}
@@ -12,6 +12,7 @@
 #include <type_traits>
 #include <utility>
 #include <string>
+#include <stdexcept>
 
 using namespace boost::variant2;
 
@@ -57,6 +58,61 @@ STATIC_ASSERT( !std::is_nothrow_move_constructible<X2>::value );
 STATIC_ASSERT( !std::is_nothrow_copy_assignable<X2>::value );
 STATIC_ASSERT( !std::is_nothrow_move_assignable<X2>::value );
 
+static int moves;
+
+struct Y1
+{
+    int v;
+
+    explicit Y1(int v = 0): v(v) {}
+    Y1(Y1 const& r): v(r.v) {}
+    Y1(Y1&& r): v(r.v) { ++moves; }
+    Y1& operator=( Y1 const& r ) { v = r.v; return *this; }
+    Y1& operator=( Y1&& r ) { v = r.v; ++moves; return *this; }
+};
+
+struct Y2
+{
+    int v;
+
+    explicit Y2(int v = 0): v(v) {}
+    Y2(Y2 const& r): v(r.v) {}
+    Y2(Y2&& r) noexcept: v(r.v) { ++moves; }
+    Y2& operator=( Y2 const& r ) { v = r.v; return *this; }
+    Y2& operator=( Y2&& r ) noexcept { v = r.v; ++moves; return *this; }
+    ~Y2() {}
+};
+
+struct Y3
+{
+    int v;
+
+    explicit Y3(int v = 0): v(v) {}
+    Y3(Y3 const& r): v(r.v) {}
+    Y3(Y3&& r) noexcept: v(r.v) { ++moves; }
+    Y3& operator=( Y3 const& r ) { v = r.v; return *this; }
+    Y3& operator=( Y3&& r ) noexcept { v = r.v; ++moves; return *this; }
+    ~Y3() {}
+};
+
+static bool throw_on_move;
+
+struct Z
+{
+    int v;
+
+    explicit Z(int v = 0): v(v) {}
+    Z(Z const& r): v(r.v) {}
+    Z(Z&& r): v(r.v) { if( throw_on_move ) throw std::runtime_error( "Z(Z&&)" ); }
+    Z& operator=( Z const& r ) { v = r.v; return *this; }
+    Z& operator=( Z&& r ) { v = r.v; return *this; }
+};
+
+template<int N> struct Q
+{
+    std::string v;
+};
+
 int main()
 {
     {
@@ -255,5 +311,129 @@ int main()
         BOOST_TEST_EQ( get<1>(v5).v, 3 );
     }
 
+    {
+        // double buffered, nothrow moves; each alternative is moved once
+
+        variant<Y1, Y2, Y3> v( Y2{1} ), v2( Y3{2} );
+
+        moves = 0;
+        swap( v, v2 );
+
+        BOOST_TEST_EQ( moves, 2 );
+
+        BOOST_TEST_EQ( v.index(), 2 );
+        BOOST_TEST_EQ( get<2>(v).v, 2 );
+
+        BOOST_TEST_EQ( v2.index(), 1 );
+        BOOST_TEST_EQ( get<1>(v2).v, 1 );
+
+        moves = 0;
+        swap( v, v2 );
+
+        BOOST_TEST_EQ( moves, 2 );
+
+        BOOST_TEST_EQ( get<1>(v).v, 1 );
+        BOOST_TEST_EQ( get<2>(v2).v, 2 );
+    }
+
+    {
+        // double buffered, a move that can throw goes through a temporary
+
+        variant<Y1, Y2> v( Y1{1} ), v2( Y2{2} );
+
+        moves = 0;
+        swap( v, v2 );
+
+        BOOST_TEST_EQ( moves, 3 );
+
+        BOOST_TEST_EQ( v.index(), 1 );
+        BOOST_TEST_EQ( get<1>(v).v, 2 );
+
+        BOOST_TEST_EQ( v2.index(), 0 );
+        BOOST_TEST_EQ( get<0>(v2).v, 1 );
+
+        moves = 0;
+        swap( v, v2 );
+
+        BOOST_TEST_EQ( moves, 3 );
+
+        BOOST_TEST_EQ( get<0>(v).v, 1 );
+        BOOST_TEST_EQ( get<1>(v2).v, 2 );
+    }
+
+    {
+        // double buffered, a throwing move leaves both variants unchanged
+
+        std::string const s( "a string too long for the small buffer" );
+
+        variant<std::string, Z> v( s ), v2( Z{2} );
+
+        throw_on_move = true;
+
+        BOOST_TEST_THROWS( swap( v2, v ), std::runtime_error );
+
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST_EQ( get<0>(v), s );
+
+        BOOST_TEST_EQ( v2.index(), 1 );
+        BOOST_TEST_EQ( get<1>(v2).v, 2 );
+
+        BOOST_TEST_THROWS( swap( v, v2 ), std::runtime_error );
+
+        BOOST_TEST_EQ( v.index(), 0 );
+        BOOST_TEST_EQ( get<0>(v), s );
+
+        BOOST_TEST_EQ( v2.index(), 1 );
+        BOOST_TEST_EQ( get<1>(v2).v, 2 );
+
+        throw_on_move = false;
+
+        swap( v, v2 );
+
+        BOOST_TEST_EQ( v.index(), 1 );
+        BOOST_TEST_EQ( get<1>(v).v, 2 );
+
+        BOOST_TEST_EQ( v2.index(), 0 );
+        BOOST_TEST_EQ( get<0>(v2), s );
+    }
+
+    {
+        // too many combinations for a single dispatch on both indices
+
+        using V = variant<Q<0>, Q<1>, Q<2>, Q<3>, Q<4>, Q<5>, Q<6>, Q<7>, Q<8>, Q<9>, Q<10>, Q<11>, Q<12>, Q<13>, Q<14>, Q<15>, Q<16>, Q<17>>;
+
+        V v( Q<3>{ "three" } ), v2( Q<17>{ "seventeen" } );
+
+        swap( v, v2 );
+
+        BOOST_TEST_EQ( v.index(), 17 );
+        BOOST_TEST_EQ( get<17>(v).v, "seventeen" );
+
+        BOOST_TEST_EQ( v2.index(), 3 );
+        BOOST_TEST_EQ( get<3>(v2).v, "three" );
+    }
+
+    {
+        // single buffered, one of them goes through a temporary
+
+        variant<int, Y2> v( 1 ), v2( Y2{2} );
+
+        moves = 0;
+        swap( v, v2 );
+
+        BOOST_TEST_EQ( moves, 1 );
+
+        BOOST_TEST_EQ( get<1>(v).v, 2 );
+        BOOST_TEST_EQ( get<0>(v2), 1 );
+
+        moves = 0;
+        swap( v, v2 );
+
+        BOOST_TEST_EQ( moves, 2 );
+
+        BOOST_TEST_EQ( get<0>(v), 1 );
+        BOOST_TEST_EQ( get<1>(v2).v, 2 );
+    }
+
     return boost::report_errors();
 }
@@ -0,0 +1,181 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <string>
+#include <utility>
+
+using namespace boost::variant2;
+
+struct X
+{
+    static int instances;
+
+    int v;
+
+    X( int v ): v( v ) { ++instances; }
+    X( X const& r ): v( r.v ) { ++instances; }
+    X( X&& r ): v( r.v ) { ++instances; }
+    ~X() { --instances; }
+
+    X& operator=( X const& r ) { v = r.v; return *this; }
+};
+
+int X::instances = 0;
+
+// copies, but can't be moved without throwing, so variants holding it are
+// double buffered
+struct Y
+{
+    static int instances;
+
+    int v;
+
+    Y( int v ): v( v ) { ++instances; }
+    Y( Y const& r ): v( r.v ) { ++instances; }
+    ~Y() { --instances; }
+
+    Y& operator=( Y const& r ) { v = r.v; return *this; }
+};
+
+int Y::instances = 0;
+
+struct Large
+{
+    char buffer[ 200 ];
+};
+
+template<class V> void test( V const& v1, V const& v2 )
+{
+    int const x = X::instances;
+    int const y = Y::instances;
+
+    {
+        V v3( v1 );
+        BOOST_TEST_EQ( v3.index(), v1.index() );
+
+        V v4( std::move( v3 ) );
+        BOOST_TEST_EQ( v4.index(), v1.index() );
+
+        v3 = v2;
+        BOOST_TEST_EQ( v3.index(), v2.index() );
+
+        v4 = std::move( v3 );
+        BOOST_TEST_EQ( v4.index(), v2.index() );
+    }
+
+    BOOST_TEST_EQ( X::instances, x );
+    BOOST_TEST_EQ( Y::instances, y );
+}
+
+int main()
+{
+    {
+        using V = variant<int, double, std::string>;
+
+        V v1( 1 );
+        V v2( std::move( v1 ) );
+
+        BOOST_TEST_EQ( get<0>( v2 ), 1 );
+
+        V v3( 2.5 );
+        V v4( v3 );
+
+        BOOST_TEST_EQ( get<1>( v4 ), 2.5 );
+
+        V v5( "abc" );
+        V v6( v5 );
+
+        BOOST_TEST_EQ( get<2>( v6 ), "abc" );
+
+        V v7( std::move( v6 ) );
+
+        BOOST_TEST_EQ( get<2>( v7 ), "abc" );
+    }
+
+    {
+        using V = variant<int, X>;
+
+        {
+            V v1( 1 );
+            V v2( v1 );
+
+            BOOST_TEST_EQ( get<0>( v2 ), 1 );
+
+            V v3( X( 2 ) );
+            V v4( v3 );
+            V v5( std::move( v4 ) );
+
+            BOOST_TEST_EQ( get<1>( v5 ).v, 2 );
+            BOOST_TEST_EQ( X::instances, 3 );
+        }
+
+        BOOST_TEST_EQ( X::instances, 0 );
+
+        test( V( 1 ), V( X( 2 ) ) );
+        test( V( X( 1 ) ), V( 2 ) );
+    }
+
+    {
+        using V = variant<int, Y>;
+
+        {
+            V v1( 1 );
+            v1 = Y( 2 );
+            v1 = 3;
+
+            V v2( v1 );
+
+            BOOST_TEST_EQ( get<0>( v2 ), 3 );
+
+            v2 = Y( 4 );
+
+            V v3( v2 );
+
+            BOOST_TEST_EQ( get<1>( v3 ).v, 4 );
+            BOOST_TEST_EQ( Y::instances, 2 );
+        }
+
+        BOOST_TEST_EQ( Y::instances, 0 );
+
+        test( V( 1 ), V( Y( 2 ) ) );
+        test( V( Y( 1 ) ), V( 2 ) );
+    }
+
+    {
+        using V = variant<int, Large, std::string>;
+
+        Large x;
+
+        for( int i = 0; i < 200; ++i ) x.buffer[ i ] = static_cast<char>( i );
+
+        V v1( x );
+        V v2( v1 );
+
+        BOOST_TEST_EQ( get<1>( v2 ).buffer[ 199 ], static_cast<char>( 199 ) );
+
+        V v3( 7 );
+        V v4( std::move( v3 ) );
+
+        BOOST_TEST_EQ( get<0>( v4 ), 7 );
+
+        V v5( "abc" );
+        V v6( v5 );
+
+        BOOST_TEST_EQ( get<2>( v6 ), "abc" );
+    }
+
+    {
+        using V = variant<int, X, Y>;
+
+        test( V( 1 ), V( X( 2 ) ) );
+        test( V( Y( 1 ) ), V( 2 ) );
+    }
+
+    return boost::report_errors();
+}
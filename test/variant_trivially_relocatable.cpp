@@ -0,0 +1,191 @@
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <type_traits>
+#include <utility>
+#include <string>
+#include <vector>
+
+using namespace boost::variant2;
+
+#define STATIC_ASSERT(...) static_assert(__VA_ARGS__, #__VA_ARGS__)
+
+static int instances;
+static int moves;
+
+// owns a heap allocation, so it isn't trivially copyable, but it doesn't
+// refer to itself, so it can be relocated by copying its bytes
+
+struct X
+{
+    int* p;
+
+    explicit X( int v = 0 ): p( new int( v ) ) { ++instances; }
+    X( X const& r ): p( new int( *r.p ) ) { ++instances; }
+    X( X&& r ) noexcept: p( r.p ) { r.p = 0; ++instances; ++moves; }
+    X& operator=( X const& r ) { *p = *r.p; return *this; }
+    X& operator=( X&& r ) noexcept { std::swap( p, r.p ); ++moves; return *this; }
+    ~X() { delete p; --instances; }
+};
+
+namespace boost
+{
+namespace variant2
+{
+
+template<> struct is_trivially_relocatable<X>: std::true_type
+{
+};
+
+} // namespace variant2
+} // namespace boost
+
+struct Y
+{
+    int v;
+
+    explicit Y( int v = 0 ): v( v ) {}
+    Y( Y const& r ): v( r.v ) {}
+    Y( Y&& r ) noexcept: v( r.v ) { ++moves; }
+    Y& operator=( Y const& ) = default;
+    Y& operator=( Y&& r ) noexcept { v = r.v; ++moves; return *this; }
+};
+
+STATIC_ASSERT( is_trivially_relocatable<int>::value );
+STATIC_ASSERT( is_trivially_relocatable<X const>::value );
+STATIC_ASSERT( !is_trivially_relocatable<Y>::value );
+STATIC_ASSERT( !is_trivially_relocatable<std::string>::value );
+
+STATIC_ASSERT( is_trivially_relocatable<variant<int, float>>::value );
+STATIC_ASSERT( is_trivially_relocatable<variant<int, X>>::value );
+STATIC_ASSERT( !is_trivially_relocatable<variant<X, Y>>::value );
+STATIC_ASSERT( is_trivially_relocatable<basic_variant<variant_policy::may_be_valueless, int, X>>::value );
+
+int main()
+{
+    {
+        using V = variant<int, X>;
+
+        alignas( V ) unsigned char buffer[ sizeof( V ) ];
+
+        V v( X( 5 ) );
+
+        moves = 0;
+
+        V* q = relocate_at( &v, reinterpret_cast<V*>( buffer ) );
+
+        BOOST_TEST_EQ( moves, 0 );
+        BOOST_TEST_EQ( *get<1>( *q ).p, 5 );
+
+        relocate_at( q, &v );
+
+        BOOST_TEST_EQ( moves, 0 );
+        BOOST_TEST_EQ( *get<1>( v ).p, 5 );
+    }
+
+    BOOST_TEST_EQ( instances, 0 );
+
+    {
+        using V = variant<int, X>;
+
+        V v( 1 ), w( X( 2 ) );
+
+        moves = 0;
+
+        swap( v, w );
+
+        BOOST_TEST_EQ( moves, 0 );
+        BOOST_TEST_EQ( *get<1>( v ).p, 2 );
+        BOOST_TEST_EQ( get<0>( w ), 1 );
+
+        v.swap( w );
+
+        BOOST_TEST_EQ( moves, 0 );
+        BOOST_TEST_EQ( get<0>( v ), 1 );
+        BOOST_TEST_EQ( *get<1>( w ).p, 2 );
+    }
+
+    BOOST_TEST_EQ( instances, 0 );
+
+    {
+        using V = variant<int, Y>;
+
+        V v( 1 ), w( Y( 2 ) );
+
+        moves = 0;
+
+        swap( v, w );
+
+        BOOST_TEST( moves > 0 );
+        BOOST_TEST_EQ( get<1>( v ).v, 2 );
+        BOOST_TEST_EQ( get<0>( w ), 1 );
+    }
+
+    {
+        using V = variant<int, X>;
+
+        std::vector<V> v;
+
+        for( int i = 0; i < 10; ++i )
+        {
+            if( i % 2 ) v.emplace_back( i ); else v.emplace_back( X( i ) );
+        }
+
+        std::allocator<V> a;
+        V* p = a.allocate( v.size() );
+
+        moves = 0;
+
+        V* e = uninitialized_relocate( v.data(), v.data() + v.size(), p );
+
+        BOOST_TEST_EQ( moves, 0 );
+        BOOST_TEST_EQ( e - p, 10 );
+
+        for( int i = 0; i < 10; ++i )
+        {
+            if( i % 2 )
+            {
+                BOOST_TEST_EQ( get<0>( p[ i ] ), i );
+            }
+            else
+            {
+                BOOST_TEST_EQ( *get<1>( p[ i ] ).p, i );
+            }
+        }
+
+        // put them back, as v still owns the storage
+        uninitialized_relocate( p, e, v.data() );
+        a.deallocate( p, 10 );
+
+        BOOST_TEST_EQ( instances, 5 );
+    }
+
+    BOOST_TEST_EQ( instances, 0 );
+
+    {
+        using V = variant<int, Y>;
+
+        std::vector<V> v( 4, V( Y( 3 ) ) );
+
+        std::allocator<V> a;
+        V* p = a.allocate( v.size() );
+
+        moves = 0;
+
+        V* e = uninitialized_relocate( v.data(), v.data() + v.size(), p );
+
+        BOOST_TEST_EQ( moves, 4 );
+        BOOST_TEST_EQ( get<1>( p[ 3 ] ).v, 3 );
+
+        uninitialized_relocate( p, e, v.data() );
+        a.deallocate( p, 4 );
+    }
+
+    return boost::report_errors();
+}
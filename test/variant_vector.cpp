@@ -0,0 +1,176 @@
+
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant_vector.hpp>
+#include <boost/variant2/algorithm.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/lightweight_test_trait.hpp>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+using namespace boost::variant2;
+
+struct Big
+{
+    int v;
+    char data[ 256 ];
+};
+
+using VV = variant_vector<int, double, std::string, Big>;
+
+#define STATIC_ASSERT(...) static_assert(__VA_ARGS__, #__VA_ARGS__)
+
+// v[0] = v[1] would rebind the reference instead of assigning the element
+
+STATIC_ASSERT( !std::is_copy_assignable<VV::reference>::value );
+STATIC_ASSERT( !std::is_copy_assignable<VV::const_reference>::value );
+STATIC_ASSERT( std::is_copy_constructible<VV::reference>::value );
+
+struct F
+{
+    int operator()( int x ) const { return x; }
+    int operator()( double x ) const { return static_cast<int>( x * 10 ); }
+    int operator()( std::string const& s ) const { return static_cast<int>( s.size() ) * 100; }
+    int operator()( Big const& b ) const { return b.v * 1000; }
+};
+
+struct Twice
+{
+    template<class T> void operator()( T& x ) const { x = x + x; }
+    void operator()( Big& b ) const { b.v *= 2; }
+};
+
+int main()
+{
+    BOOST_TEST_EQ( (variant_size<VV::reference>::value), 4 );
+    BOOST_TEST_TRAIT_TRUE((std::is_same<variant_alternative_t<2, VV::reference>, std::string>));
+    BOOST_TEST_TRAIT_TRUE((std::is_same<variant_alternative_t<2, VV::const_reference>, std::string const>));
+    BOOST_TEST_TRAIT_TRUE((std::is_same<std::iterator_traits<VV::iterator>::iterator_category, std::random_access_iterator_tag>));
+
+    {
+        VV v;
+
+        BOOST_TEST( v.empty() );
+        BOOST_TEST_EQ( v.size(), 0 );
+        BOOST_TEST( v.begin() == v.end() );
+    }
+
+    {
+        VV v;
+
+        v.push_back( 1 );
+        v.push_back( 2.5 );
+        v.push_back( std::string( "abc" ) );
+        v.emplace_back<Big>( Big{ 4, {} } );
+        v.emplace_back<0>( 5 );
+        v.push_back( variant<int, double, std::string, Big>( std::string( "de" ) ) );
+
+        BOOST_TEST_EQ( v.size(), 6 );
+
+        BOOST_TEST_EQ( v[ 0 ].index(), 0 );
+        BOOST_TEST_EQ( v[ 1 ].index(), 1 );
+        BOOST_TEST_EQ( v[ 2 ].index(), 2 );
+        BOOST_TEST_EQ( v[ 3 ].index(), 3 );
+        BOOST_TEST_EQ( v[ 4 ].index(), 0 );
+        BOOST_TEST_EQ( v[ 5 ].index(), 2 );
+
+        BOOST_TEST_EQ( get<0>( v[ 0 ] ), 1 );
+        BOOST_TEST_EQ( get<double>( v[ 1 ] ), 2.5 );
+        BOOST_TEST_EQ( get<2>( v[ 2 ] ), std::string( "abc" ) );
+        BOOST_TEST_EQ( get<Big>( v[ 3 ] ).v, 4 );
+        BOOST_TEST_EQ( get<int>( v[ 4 ] ), 5 );
+        BOOST_TEST_EQ( get<std::string>( v[ 5 ] ), std::string( "de" ) );
+
+        BOOST_TEST_THROWS( get<1>( v[ 0 ] ), bad_variant_access );
+        BOOST_TEST_THROWS( get<int>( v[ 2 ] ), bad_variant_access );
+
+        BOOST_TEST( holds_alternative<int>( v[ 0 ] ) );
+        BOOST_TEST( !holds_alternative<double>( v[ 0 ] ) );
+
+        {
+            auto r = v[ 1 ];
+
+            BOOST_TEST_EQ( *get_if<1>( &r ), 2.5 );
+            BOOST_TEST_EQ( get_if<0>( &r ), static_cast<int*>( 0 ) );
+            BOOST_TEST_EQ( *get_if<double>( &r ), 2.5 );
+            BOOST_TEST_EQ( get_if<std::string>( &r ), static_cast<std::string*>( 0 ) );
+        }
+
+        get<0>( v[ 0 ] ) = 7;
+        BOOST_TEST_EQ( get<0>( v[ 0 ] ), 7 );
+
+        visit( Twice(), v[ 2 ] );
+        BOOST_TEST_EQ( get<2>( v[ 2 ] ), std::string( "abcabc" ) );
+
+        BOOST_TEST_EQ( visit( F(), v[ 0 ] ), 7 );
+        BOOST_TEST_EQ( visit( F(), v[ 1 ] ), 25 );
+        BOOST_TEST_EQ( visit( F(), v[ 2 ] ), 600 );
+        BOOST_TEST_EQ( visit( F(), v[ 3 ] ), 4000 );
+
+        {
+            int s = 0;
+
+            for( auto r: v )
+            {
+                s += visit( F(), r );
+            }
+
+            BOOST_TEST_EQ( s, 7 + 25 + 600 + 4000 + 5 + 200 );
+
+            int s2 = 0;
+            visit_each( v.begin(), v.end(), [&]( auto const& x ){ s2 += F()( x ); } );
+
+            BOOST_TEST_EQ( s2, s );
+        }
+
+        {
+            VV const& cv = v;
+
+            VV::const_reference r = cv[ 4 ];
+            BOOST_TEST_EQ( get<0>( r ), 5 );
+
+            VV::const_iterator it = v.begin();
+            BOOST_TEST_EQ( get<0>( *it ), 7 );
+            BOOST_TEST_EQ( it[ 5 ].index(), 2 );
+            BOOST_TEST_EQ( cv.end() - it, 6 );
+
+            BOOST_TEST_EQ( visit( F(), cv[ 2 ] ), 600 );
+        }
+
+        {
+            variant<int, double, std::string, Big> w = v[ 2 ];
+            BOOST_TEST_EQ( get<2>( w ), std::string( "abcabc" ) );
+        }
+
+        BOOST_TEST_EQ( v.alternative<0>().size(), 2 );
+        BOOST_TEST_EQ( v.alternative<0>()[ 1 ], 5 );
+        BOOST_TEST_EQ( v.alternative<2>().size(), 2 );
+        BOOST_TEST_EQ( v.alternative<3>().size(), 1 );
+
+        v.pop_back();
+
+        BOOST_TEST_EQ( v.size(), 5 );
+        BOOST_TEST_EQ( v.alternative<2>().size(), 1 );
+        BOOST_TEST_EQ( get<0>( v.back() ), 5 );
+
+        VV v2;
+        swap( v, v2 );
+
+        BOOST_TEST( v.empty() );
+        BOOST_TEST_EQ( v2.size(), 5 );
+
+        v2.clear();
+
+        BOOST_TEST( v2.empty() );
+        BOOST_TEST( v2.alternative<0>().empty() );
+    }
+
+    return boost::report_errors();
+}
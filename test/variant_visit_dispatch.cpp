@@ -0,0 +1,88 @@
+
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/mp11.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <boost/core/lightweight_test_trait.hpp>
+#include <type_traits>
+#include <utility>
+#include <string>
+
+using namespace boost::variant2;
+using namespace boost::mp11;
+
+template<class I> struct Z
+{
+    int v;
+};
+
+using Z40 = mp_rename<mp_transform<Z, mp_iota_c<40>>, variant>;
+
+struct F
+{
+    template<class I> int operator()( Z<I> const& z ) const
+    {
+        return static_cast<int>( I::value ) * 100 + z.v;
+    }
+};
+
+template<class D> void test()
+{
+    {
+        variant<int> v( 1 );
+
+        BOOST_TEST_EQ( (visit<D>( []( auto x ){ return x; }, v )), 1 );
+        BOOST_TEST_EQ( (visit<D>( []( auto x ){ return x; }, std::move(v) )), 1 );
+    }
+
+    {
+        variant<int, float, std::string> v( std::string( "s" ) );
+
+        BOOST_TEST_EQ( (visit<D>( []( auto const& x ){ return sizeof(x); }, v )), sizeof(std::string) );
+
+        v = 2.0f;
+        BOOST_TEST_EQ( (visit<D>( []( auto const& x ){ return sizeof(x); }, v )), sizeof(float) );
+
+        v = 3;
+        BOOST_TEST_EQ( (visit<D>( []( auto const& x ){ return sizeof(x); }, v )), sizeof(int) );
+    }
+
+    {
+        variant<int, float> v1( 1 );
+        variant<char, int> v2( 'a' );
+        variant<int, long> v3( 3L );
+
+        BOOST_TEST_EQ( (visit<D>( []( auto x1, auto x2, auto x3 ){ return (long)x1 + x2 + x3; }, v1, v2, v3 )), 1 + 'a' + 3L );
+    }
+
+    mp_for_each<mp_iota_c<40>>( []( auto I ){
+
+        Z40 v( in_place_index<I>, Z<decltype(I)>{ 7 } );
+
+        BOOST_TEST_EQ( visit<D>( F(), v ), static_cast<int>( I ) * 100 + 7 );
+        BOOST_TEST_EQ( visit( F(), v ), static_cast<int>( I ) * 100 + 7 );
+
+    });
+}
+
+int main()
+{
+#if !defined( BOOST_VARIANT2_DEFAULT_DISPATCH )
+
+    BOOST_TEST_TRAIT_TRUE((std::is_same<dispatch::default_dispatch, dispatch::dense_switch>));
+
+#endif
+
+    test<dispatch::dense_switch>();
+    test<dispatch::jump_table>();
+    test<dispatch::binary_search>();
+    test<dispatch::if_chain>();
+
+    return boost::report_errors();
+}
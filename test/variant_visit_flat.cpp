@@ -0,0 +1,96 @@
+
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/mp11.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <type_traits>
+#include <utility>
+#include <string>
+
+using namespace boost::variant2;
+using namespace boost::mp11;
+
+template<class I> struct Z
+{
+    int v;
+};
+
+template<std::size_t N> using V = mp_rename<mp_transform<Z, mp_iota_c<N>>, variant>;
+
+struct F
+{
+    template<class... I> int operator()( Z<I> const&... z ) const
+    {
+        int r = 0;
+        int const a[] = { ( r = r * 100 + static_cast<int>( I::value ) * 10 + z.v, 0 )... };
+        (void)a;
+        return r;
+    }
+};
+
+struct G
+{
+    int operator()( int&, std::string&& ) const { return 1; }
+    int operator()( int&, float&& ) const { return 2; }
+    int operator()( char const&, std::string&& ) const { return 3; }
+    int operator()( char const&, float&& ) const { return 4; }
+};
+
+int main()
+{
+    // product of the sizes <= BOOST_VARIANT2_MAX_FLAT_VISIT
+
+    mp_for_each<mp_iota_c<4>>( []( auto I ){
+
+    using II = decltype(I);
+
+    mp_for_each<mp_iota_c<5>>( []( auto J ){
+
+        int const I = II::value;
+
+        V<4> v1( in_place_index<II::value>, Z<II>{ 1 } );
+        V<5> v2( in_place_index<J>, Z<decltype(J)>{ 2 } );
+
+        BOOST_TEST_EQ( visit( F(), v1, v2 ), ( I * 10 + 1 ) * 100 + J * 10 + 2 );
+
+        V<3> v3( in_place_index<2>, Z<mp_size_t<2>>{ 3 } );
+
+        BOOST_TEST_EQ( visit( F(), v1, v2, v3 ), ( ( I * 10 + 1 ) * 100 + J * 10 + 2 ) * 100 + 23 );
+        BOOST_TEST_EQ( visit( F(), v3, v1, v2 ), ( 23 * 100 + I * 10 + 1 ) * 100 + J * 10 + 2 );
+
+    });
+    });
+
+    // product of the sizes > BOOST_VARIANT2_MAX_FLAT_VISIT
+
+    {
+        V<17> v1( in_place_index<11>, Z<mp_size_t<11>>{ 1 } );
+        V<16> v2( in_place_index<5>, Z<mp_size_t<5>>{ 2 } );
+        V<2> v3( in_place_index<1>, Z<mp_size_t<1>>{ 3 } );
+
+        BOOST_TEST_EQ( visit( F(), v1, v2 ), 111 * 100 + 52 );
+        BOOST_TEST_EQ( visit( F(), v1, v2, v3 ), ( 111 * 100 + 52 ) * 100 + 13 );
+        BOOST_TEST_EQ( visit( F(), v3, v1, v2 ), ( 13 * 100 + 111 ) * 100 + 52 );
+    }
+
+    // value categories
+
+    {
+        variant<int, char> const c1( 'a' );
+        variant<int, char> v1( 1 );
+        variant<std::string, float> v2( 1.0f );
+
+        BOOST_TEST_EQ( visit( G(), v1, variant<std::string, float>( "s" ) ), 1 );
+        BOOST_TEST_EQ( visit( G(), v1, std::move(v2) ), 2 );
+        BOOST_TEST_EQ( visit( G(), c1, variant<std::string, float>( "s" ) ), 3 );
+        BOOST_TEST_EQ( visit( G(), c1, std::move(v2) ), 4 );
+    }
+
+    return boost::report_errors();
+}
@@ -0,0 +1,83 @@
+
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/variant.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <type_traits>
+#include <utility>
+#include <string>
+
+using namespace boost::variant2;
+
+struct F
+{
+    int operator()( int& ) const { return 1; }
+    int operator()( int const& ) const { return 2; }
+    int operator()( int&& ) const { return 3; }
+    int operator()( float const& ) const { return 4; }
+    int operator()( std::string const& ) const { return 5; }
+    int operator()( std::string&& ) const { return 6; }
+};
+
+int main()
+{
+    {
+        variant<int, float, std::string> v( 1 );
+
+        BOOST_TEST_EQ( visit_likely<0>( F(), v ), 1 );
+        BOOST_TEST_EQ( visit_likely<1>( F(), v ), 1 );
+        BOOST_TEST_EQ( (visit_likely<2, 0>( F(), v )), 1 );
+        BOOST_TEST_EQ( visit_likely<0>( F(), static_cast<variant<int, float, std::string> const&>( v ) ), 2 );
+        BOOST_TEST_EQ( visit_likely<0>( F(), std::move( v ) ), 3 );
+
+        BOOST_TEST_EQ( visit_likely<int>( F(), v ), 1 );
+        BOOST_TEST_EQ( visit_likely<float>( F(), v ), 1 );
+        BOOST_TEST_EQ( (visit_likely<std::string, int>( F(), v )), 1 );
+    }
+
+    {
+        variant<int, float, std::string> v( 1.0f );
+
+        BOOST_TEST_EQ( visit_likely<0>( F(), v ), 4 );
+        BOOST_TEST_EQ( visit_likely<1>( F(), v ), 4 );
+        BOOST_TEST_EQ( visit_likely<float>( F(), v ), 4 );
+        BOOST_TEST_EQ( (visit_likely<int, std::string>( F(), v )), 4 );
+    }
+
+    {
+        variant<int, float, std::string> const v( "s" );
+
+        BOOST_TEST_EQ( visit_likely<2>( F(), v ), 5 );
+        BOOST_TEST_EQ( visit_likely<0>( F(), v ), 5 );
+        BOOST_TEST_EQ( visit_likely<std::string>( F(), v ), 5 );
+    }
+
+    {
+        variant<int, float, std::string> v( "s" );
+
+        BOOST_TEST_EQ( visit_likely<2>( F(), std::move( v ) ), 6 );
+        BOOST_TEST_EQ( visit_likely<int>( F(), std::move( v ) ), 6 );
+    }
+
+    {
+        variant<int, int, float> v( in_place_index<1>, 1 );
+
+        BOOST_TEST_EQ( visit_likely<1>( F(), v ), 1 );
+        BOOST_TEST_EQ( visit_likely<0>( F(), v ), 1 );
+        BOOST_TEST_EQ( visit_likely<float>( F(), v ), 1 );
+    }
+
+    {
+        basic_variant<variant_policy::may_be_valueless, int, float> v( 2.0f );
+
+        BOOST_TEST_EQ( visit_likely<1>( F(), v ), 4 );
+        BOOST_TEST_EQ( visit_likely<int>( F(), v ), 4 );
+    }
+
+    return boost::report_errors();
+}
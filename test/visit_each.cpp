@@ -0,0 +1,155 @@
+
+// Copyright 2017 Peter Dimov.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+#include <boost/variant2/algorithm.hpp>
+#include <boost/core/lightweight_test.hpp>
+#include <list>
+#include <string>
+#include <vector>
+
+using namespace boost::variant2;
+
+using V = variant<int, float, std::string>;
+
+struct S
+{
+    long ints = 0;
+    double floats = 0;
+    std::size_t chars = 0;
+    std::size_t calls = 0;
+
+    void operator()( int const& x ) { ints += x; ++calls; }
+    void operator()( float const& x ) { floats += x; ++calls; }
+    void operator()( std::string const& x ) { chars += x.size(); ++calls; }
+};
+
+struct R
+{
+    std::string seq;
+
+    void operator()( int const& x ) { seq += 'i'; seq += static_cast<char>( '0' + x % 10 ); }
+    void operator()( float const& ) { seq += 'f'; }
+    void operator()( std::string const& x ) { seq += x; }
+};
+
+template<class C> void make( C& c, std::size_t n )
+{
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        switch( i * 7 % 5 )
+        {
+        case 0: case 3: c.push_back( V( static_cast<int>( i ) ) ); break;
+        case 1: c.push_back( V( static_cast<float>( i ) ) ); break;
+        default: c.push_back( V( std::string( i % 3, 'x' ) ) ); break;
+        }
+    }
+}
+
+template<class It, class F> F element_wise( It first, It last, F f )
+{
+    for( ; first != last; ++first )
+    {
+        visit( [&]( auto const& x ){ f( x ); }, *first );
+    }
+
+    return f;
+}
+
+template<class C> void test( std::size_t n )
+{
+    C c;
+    make( c, n );
+
+    S s1 = element_wise( c.begin(), c.end(), S() );
+    S s2 = visit_each( c.begin(), c.end(), S() );
+    S s3 = visit_each_ordered( c.begin(), c.end(), S() );
+
+    BOOST_TEST_EQ( s2.calls, n );
+    BOOST_TEST_EQ( s2.ints, s1.ints );
+    BOOST_TEST_EQ( s2.floats, s1.floats );
+    BOOST_TEST_EQ( s2.chars, s1.chars );
+
+    BOOST_TEST_EQ( s3.calls, n );
+    BOOST_TEST_EQ( s3.ints, s1.ints );
+    BOOST_TEST_EQ( s3.floats, s1.floats );
+    BOOST_TEST_EQ( s3.chars, s1.chars );
+
+    R r1 = element_wise( c.begin(), c.end(), R() );
+    R r2 = visit_each_ordered( c.begin(), c.end(), R() );
+
+    BOOST_TEST_EQ( r2.seq, r1.seq );
+
+    C const& cc = c;
+
+    S s4 = visit_each( cc.begin(), cc.end(), S() );
+    BOOST_TEST_EQ( s4.calls, n );
+    BOOST_TEST_EQ( s4.ints, s1.ints );
+}
+
+int main()
+{
+    test<std::vector<V>>( 0 );
+    test<std::vector<V>>( 1 );
+    test<std::vector<V>>( 255 );
+    test<std::vector<V>>( 256 );
+    test<std::vector<V>>( 1000 );
+
+    test<std::list<V>>( 0 );
+    test<std::list<V>>( 1000 );
+
+    {
+        std::vector<V> v;
+        make( v, 600 );
+
+        visit_each( v.begin(), v.end(), []( auto& x ){ x = x + x; } );
+
+        std::vector<V> w;
+        make( w, 600 );
+
+        for( auto& x: w ) visit( []( auto& y ){ y = y + y; }, x );
+
+        BOOST_TEST( v == w );
+    }
+
+    {
+        // long runs
+
+        std::vector<V> v;
+
+        for( int i = 0; i < 1000; ++i )
+        {
+            if( i / 10 % 2 ) v.push_back( V( i ) ); else v.push_back( V( std::string( i % 4, 'x' ) ) );
+        }
+
+        S s1 = element_wise( v.begin(), v.end(), S() );
+        S s2 = visit_each( v.begin(), v.end(), S() );
+
+        BOOST_TEST_EQ( s2.calls, 1000 );
+        BOOST_TEST_EQ( s2.ints, s1.ints );
+        BOOST_TEST_EQ( s2.chars, s1.chars );
+    }
+
+    {
+        std::vector<variant<int, int>> v;
+
+        for( int i = 0; i < 300; ++i )
+        {
+            if( i % 3 ) v.emplace_back( in_place_index<0>, i ); else v.emplace_back( in_place_index<1>, -i );
+        }
+
+        int s = 0;
+        visit_each( v.begin(), v.end(), [&]( int x ){ s += x; } );
+
+        int s2 = 0;
+        for( int i = 0; i < 300; ++i ) s2 += i % 3? i: -i;
+
+        BOOST_TEST_EQ( s, s2 );
+    }
+
+    return boost::report_errors();
+}